@@ -0,0 +1,407 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ADAPTIVE_TRIE_SSE2 1
+#endif
+#include "Arena.h"
+#include "TrieStats.h"
+
+// Способ с адаптивными узлами: размер узла растет вместе с числом детей
+// (4 -> 16 -> 48 -> 256), как в Adaptive Radix Tree
+
+enum AdaptiveKind : uint8_t { NODE4, NODE16, NODE48, NODE256 };
+
+struct AdaptiveNode {
+    uint8_t kind;
+    bool isEndOfWord;
+    uint16_t childCount;
+
+    explicit AdaptiveNode(uint8_t kind) : kind(kind), isEndOfWord(false), childCount(0) {}
+};
+
+// До 4 детей: отсортированные ключи, линейный поиск
+struct AdaptiveNode4 : AdaptiveNode {
+    uint8_t keys[4];
+    AdaptiveNode* children[4];
+
+    static const uint8_t KIND = NODE4;
+
+    AdaptiveNode4() : AdaptiveNode(KIND) {}
+};
+
+// До 16 детей: отсортированные ключи, сравнение всех ключей одной SSE2-командой
+struct AdaptiveNode16 : AdaptiveNode {
+    uint8_t keys[16];
+    AdaptiveNode* children[16];
+
+    static const uint8_t KIND = NODE16;
+
+    AdaptiveNode16() : AdaptiveNode(KIND) {}
+};
+
+// До 48 детей: индекс по байту (0 - нет ребенка, иначе номер слота + 1)
+struct AdaptiveNode48 : AdaptiveNode {
+    uint8_t index[256];
+    AdaptiveNode* children[48];
+
+    static const uint8_t KIND = NODE48;
+
+    AdaptiveNode48() : AdaptiveNode(KIND) {
+        std::memset(index, 0, sizeof(index));
+    }
+};
+
+// Полный массив указателей
+struct AdaptiveNode256 : AdaptiveNode {
+    AdaptiveNode* children[256];
+
+    static const uint8_t KIND = NODE256;
+
+    AdaptiveNode256() : AdaptiveNode(KIND) {
+        for (int i = 0; i < 256; i++)
+            children[i] = nullptr;
+    }
+};
+
+inline size_t adaptiveNodeSize(uint8_t kind) {
+    switch (kind) {
+    case NODE4: return sizeof(AdaptiveNode4);
+    case NODE16: return sizeof(AdaptiveNode16);
+    case NODE48: return sizeof(AdaptiveNode48);
+    default: return sizeof(AdaptiveNode256);
+    }
+}
+
+// Обход детей узла в порядке возрастания ключа
+template <class F>
+void adaptiveForEachChild(AdaptiveNode* node, F visit) {
+    switch (node->kind) {
+    case NODE4: {
+        AdaptiveNode4* n = static_cast<AdaptiveNode4*>(node);
+        for (int i = 0; i < n->childCount; i++) visit(n->keys[i], n->children[i]);
+        break;
+    }
+    case NODE16: {
+        AdaptiveNode16* n = static_cast<AdaptiveNode16*>(node);
+        for (int i = 0; i < n->childCount; i++) visit(n->keys[i], n->children[i]);
+        break;
+    }
+    case NODE48: {
+        AdaptiveNode48* n = static_cast<AdaptiveNode48*>(node);
+        for (int key = 0; key < 256; key++) {
+            if (n->index[key]) visit(static_cast<uint8_t>(key), n->children[n->index[key] - 1]);
+        }
+        break;
+    }
+    default: {
+        AdaptiveNode256* n = static_cast<AdaptiveNode256*>(node);
+        for (int key = 0; key < 256; key++) {
+            if (n->children[key]) visit(static_cast<uint8_t>(key), n->children[key]);
+        }
+        break;
+    }
+    }
+}
+
+// Адрес ячейки с ребенком по байту key или nullptr
+inline AdaptiveNode** adaptiveFindChild(AdaptiveNode* node, uint8_t key) {
+    switch (node->kind) {
+    case NODE4: {
+        AdaptiveNode4* n = static_cast<AdaptiveNode4*>(node);
+        for (int i = 0; i < n->childCount; i++) {
+            if (n->keys[i] == key) return &n->children[i];
+        }
+        return nullptr;
+    }
+    case NODE16: {
+        AdaptiveNode16* n = static_cast<AdaptiveNode16*>(node);
+#ifdef ADAPTIVE_TRIE_SSE2
+        __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(key)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(n->keys)));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1u << n->childCount) - 1);
+        if (!mask) return nullptr;
+        int i = 0;
+        while (!(mask & 1u)) {
+            mask >>= 1;
+            i++;
+        }
+        return &n->children[i];
+#else
+        for (int i = 0; i < n->childCount; i++) {
+            if (n->keys[i] == key) return &n->children[i];
+        }
+        return nullptr;
+#endif
+    }
+    case NODE48: {
+        AdaptiveNode48* n = static_cast<AdaptiveNode48*>(node);
+        return n->index[key] ? &n->children[n->index[key] - 1] : nullptr;
+    }
+    default: {
+        AdaptiveNode256* n = static_cast<AdaptiveNode256*>(node);
+        return n->children[key] ? &n->children[key] : nullptr;
+    }
+    }
+}
+
+class AdaptiveTrie {
+private:
+    std::unique_ptr<Arena> ownArena;  // Собственная арена, если внешняя не передана
+    Arena* arena;
+    std::vector<void*> freeNodes[4];  // Узлы, освободившиеся при росте, по видам
+    TrieStats counters;  // Параметры дерева, обновляются в insert
+
+    template <class T>
+    T* allocNode() {
+        std::vector<void*>& list = freeNodes[T::KIND];
+        if (!list.empty()) {
+            void* p = list.back();
+            list.pop_back();
+            return new (p) T();
+        }
+        return arena->create<T>();
+    }
+
+    // Копия узла в узел следующего размера; старый узел уходит в список свободных
+    AdaptiveNode* grow(AdaptiveNode* node) {
+        AdaptiveNode* bigger = nullptr;
+        switch (node->kind) {
+        case NODE4: {
+            AdaptiveNode4* n = static_cast<AdaptiveNode4*>(node);
+            AdaptiveNode16* m = allocNode<AdaptiveNode16>();
+            std::memcpy(m->keys, n->keys, n->childCount);
+            std::memcpy(m->children, n->children, n->childCount * sizeof(AdaptiveNode*));
+            bigger = m;
+            break;
+        }
+        case NODE16: {
+            AdaptiveNode16* n = static_cast<AdaptiveNode16*>(node);
+            AdaptiveNode48* m = allocNode<AdaptiveNode48>();
+            for (int i = 0; i < n->childCount; i++) {
+                m->index[n->keys[i]] = static_cast<uint8_t>(i + 1);
+                m->children[i] = n->children[i];
+            }
+            bigger = m;
+            break;
+        }
+        default: {
+            AdaptiveNode48* n = static_cast<AdaptiveNode48*>(node);
+            AdaptiveNode256* m = allocNode<AdaptiveNode256>();
+            for (int key = 0; key < 256; key++) {
+                if (n->index[key]) m->children[key] = n->children[n->index[key] - 1];
+            }
+            bigger = m;
+            break;
+        }
+        }
+        bigger->isEndOfWord = node->isEndOfWord;
+        bigger->childCount = node->childCount;
+        counters.memoryBytes += adaptiveNodeSize(bigger->kind) - adaptiveNodeSize(node->kind);
+        freeNodes[node->kind].push_back(node);
+        return bigger;
+    }
+
+    static bool isFull(const AdaptiveNode* node) {
+        switch (node->kind) {
+        case NODE4: return node->childCount == 4;
+        case NODE16: return node->childCount == 16;
+        case NODE48: return node->childCount == 48;
+        default: return false;
+        }
+    }
+
+    // Вставка ребенка по ключу; *slot может быть заменен на узел большего размера
+    void addChild(AdaptiveNode** slot, uint8_t key, AdaptiveNode* child) {
+        if (isFull(*slot)) {
+            *slot = grow(*slot);
+        }
+        AdaptiveNode* node = *slot;
+        switch (node->kind) {
+        case NODE4: {
+            AdaptiveNode4* n = static_cast<AdaptiveNode4*>(node);
+            int i = n->childCount;
+            while (i > 0 && n->keys[i - 1] > key) {
+                n->keys[i] = n->keys[i - 1];
+                n->children[i] = n->children[i - 1];
+                i--;
+            }
+            n->keys[i] = key;
+            n->children[i] = child;
+            break;
+        }
+        case NODE16: {
+            AdaptiveNode16* n = static_cast<AdaptiveNode16*>(node);
+            int i = n->childCount;
+            while (i > 0 && n->keys[i - 1] > key) {
+                n->keys[i] = n->keys[i - 1];
+                n->children[i] = n->children[i - 1];
+                i--;
+            }
+            n->keys[i] = key;
+            n->children[i] = child;
+            break;
+        }
+        case NODE48: {
+            AdaptiveNode48* n = static_cast<AdaptiveNode48*>(node);
+            n->children[n->childCount] = child;
+            n->index[key] = static_cast<uint8_t>(n->childCount + 1);
+            break;
+        }
+        default:
+            static_cast<AdaptiveNode256*>(node)->children[key] = child;
+            break;
+        }
+        node->childCount++;
+    }
+
+    void resetCounters() {
+        counters = TrieStats();
+        counters.memoryBytes = sizeof(AdaptiveNode4);
+    }
+
+    void destroyNode(void* node, int kind) {
+        switch (kind) {
+        case NODE4: arena->destroy(static_cast<AdaptiveNode4*>(node)); break;
+        case NODE16: arena->destroy(static_cast<AdaptiveNode16*>(node)); break;
+        case NODE48: arena->destroy(static_cast<AdaptiveNode48*>(node)); break;
+        default: arena->destroy(static_cast<AdaptiveNode256*>(node)); break;
+        }
+    }
+
+    // Возврат во внешнюю арену всех узлов дерева и списков свободных
+    void releaseTree() {
+        std::vector<AdaptiveNode*> stack;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            AdaptiveNode* node = stack.back();
+            stack.pop_back();
+            adaptiveForEachChild(node, [&](uint8_t, AdaptiveNode* child) {
+                stack.push_back(child);
+            });
+            destroyNode(node, node->kind);
+        }
+        for (int kind = 0; kind < 4; kind++) {
+            for (void* node : freeNodes[kind]) {
+                destroyNode(node, kind);
+            }
+            freeNodes[kind].clear();
+        }
+    }
+
+public:
+    AdaptiveNode* root;
+
+    explicit AdaptiveTrie(Arena* externalArena = nullptr) {
+        if (!externalArena) {
+            ownArena.reset(new Arena());
+            externalArena = ownArena.get();
+        }
+        arena = externalArena;
+        root = arena->create<AdaptiveNode4>();
+        resetCounters();
+    }
+
+    // Собственная арена освобождается целиком; внешняя общая, поэтому узлы
+    // возвращаются в ее списки свободных и reset() для нее не вызывается
+    ~AdaptiveTrie() {
+        if (!ownArena) releaseTree();
+    }
+
+    AdaptiveTrie(const AdaptiveTrie&) = delete;
+    AdaptiveTrie& operator=(const AdaptiveTrie&) = delete;
+
+    // Освобождение всех узлов: за O(1) в собственной арене, по одному - во внешней
+    void clear() {
+        if (ownArena) {
+            arena->reset();
+            for (std::vector<void*>& list : freeNodes) {
+                list.clear();
+            }
+        }
+        else {
+            releaseTree();
+        }
+        root = arena->create<AdaptiveNode4>();
+        resetCounters();
+    }
+
+    void insert(const std::string& word) {
+        AdaptiveNode** slot = &root;
+        for (char ch : word) {
+            uint8_t key = static_cast<uint8_t>(ch);
+            AdaptiveNode** childSlot = adaptiveFindChild(*slot, key);
+            if (!childSlot) {
+                counters.onChildAdded((*slot)->childCount, slot == &root, sizeof(AdaptiveNode4));
+                addChild(slot, key, allocNode<AdaptiveNode4>());
+                childSlot = adaptiveFindChild(*slot, key);
+            }
+            slot = childSlot;
+        }
+        if (!(*slot)->isEndOfWord) {
+            counters.words++;
+            (*slot)->isEndOfWord = true;
+        }
+    }
+
+    bool search(const std::string& word) const {
+        AdaptiveNode* current = root;
+        for (char ch : word) {
+            AdaptiveNode** child = adaptiveFindChild(current, static_cast<uint8_t>(ch));
+            if (!child) {
+                return false;
+            }
+            current = *child;
+        }
+        return current->isEndOfWord;
+    }
+
+    // Параметры дерева без обхода
+    const TrieStats& stats() const {
+        return counters;
+    }
+
+    size_t calculateMemoryUsage() const {
+        return counters.memoryBytes;
+    }
+
+    // Количество узлов каждого вида (4, 16, 48, 256)
+    std::vector<int> nodeKindCounts() const {
+        std::vector<int> counts(4, 0);
+        std::vector<AdaptiveNode*> stack;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            AdaptiveNode* node = stack.back();
+            stack.pop_back();
+            counts[node->kind]++;
+            adaptiveForEachChild(node, [&](uint8_t, AdaptiveNode* child) {
+                stack.push_back(child);
+            });
+        }
+        return counts;
+    }
+
+    int totalChars() const {
+        return counters.totalNodes;
+    }
+
+    int wordCount() const {
+        return counters.words;
+    }
+
+    int internalNodeCount() const {
+        return counters.internalNodes;
+    }
+
+    int branchingNodeCount() const {
+        return counters.branchingNodes;
+    }
+
+    double averageBranchingPaths() const {
+        return counters.avgBranching();
+    }
+};
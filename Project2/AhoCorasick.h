@@ -0,0 +1,154 @@
+﻿#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Автомат Ахо-Корасик над словами дерева: все вхождения всех слов в тексте
+// за один линейный проход. Состояния - узлы дерева, пронумерованные обходом
+// в ширину, поэтому дети состояния s занимают номера [firstChild[s], firstChild[s + 1])
+// и упорядочены по байту. Из каждого состояния ведет ссылка неудачи (самый длинный
+// собственный суффикс пути, который тоже есть в дереве) и ссылка выхода
+// (ближайший по ссылкам неудачи конец слова).
+class AhoCorasick {
+private:
+    std::vector<int32_t> firstChild;  // Первый ребенок состояния, в конце - число состояний
+    std::vector<unsigned char> labels;  // Символ перехода в состояние
+    std::vector<int32_t> fail;
+    std::vector<int32_t> output;  // Ближайшее состояние-слово по ссылкам неудачи или -1
+    std::vector<uint32_t> depth;  // Длина пути до состояния
+    std::vector<char> endOfWord;
+    std::array<int32_t, 256> rootNext{};  // Переходы корня без поиска, отсутствующие ведут в корень
+
+    // Переход по дереву без ссылок неудачи или -1
+    int32_t child(int32_t s, unsigned char c) const {
+        const unsigned char* begin = labels.data() + firstChild[s];
+        const unsigned char* end = labels.data() + firstChild[s + 1];
+        const unsigned char* it = std::lower_bound(begin, end, c);
+        return (it != end && *it == c) ? static_cast<int32_t>(it - labels.data()) : -1;
+    }
+
+public:
+    // Построение в два прохода в ширину: нумерация состояний, затем ссылки неудачи.
+    // childrenOf(node, out) добавляет пары (символ, ребенок), isEnd(node) - конец слова.
+    template <class Node, class ChildrenOf, class IsEnd>
+    static AhoCorasick build(Node* root, ChildrenOf childrenOf, IsEnd isEnd) {
+        AhoCorasick automaton;
+        std::vector<Node*> level;  // Очередь обхода в ширину
+        std::vector<std::pair<char, Node*>> kids;
+        level.push_back(root);
+        automaton.labels.push_back(0);
+        automaton.depth.push_back(0);
+        for (size_t head = 0; head < level.size(); head++) {
+            Node* node = level[head];
+            automaton.firstChild.push_back(static_cast<int32_t>(level.size()));
+            automaton.endOfWord.push_back(head != 0 && isEnd(node) ? 1 : 0);  // Пустое слово не ищется
+            kids.clear();
+            childrenOf(node, kids);
+            std::sort(kids.begin(), kids.end(),
+                [](const std::pair<char, Node*>& a, const std::pair<char, Node*>& b) {
+                    return static_cast<unsigned char>(a.first) < static_cast<unsigned char>(b.first);
+                });
+            for (const std::pair<char, Node*>& kid : kids) {
+                automaton.labels.push_back(static_cast<unsigned char>(kid.first));
+                automaton.depth.push_back(automaton.depth[head] + 1);
+                level.push_back(kid.second);
+            }
+        }
+        automaton.firstChild.push_back(static_cast<int32_t>(level.size()));
+
+        size_t count = level.size();
+        automaton.fail.assign(count, 0);
+        automaton.output.assign(count, -1);
+        automaton.rootNext.fill(0);
+        for (int32_t t = automaton.firstChild[0]; t < automaton.firstChild[1]; t++) {
+            automaton.rootNext[automaton.labels[t]] = t;
+        }
+        // Ссылки неудачи ведут на меньшую глубину, поэтому к моменту обработки
+        // состояния они уже посчитаны у всех состояний, через которые идет поиск
+        for (int32_t s = 0; s < static_cast<int32_t>(count); s++) {
+            for (int32_t t = automaton.firstChild[s]; t < automaton.firstChild[s + 1]; t++) {
+                if (s != 0) automaton.fail[t] = automaton.step(automaton.fail[s], automaton.labels[t]);
+                int32_t f = automaton.fail[t];
+                automaton.output[t] = automaton.endOfWord[f] ? f : automaton.output[f];
+            }
+        }
+        return automaton;
+    }
+
+    // Переход автомата по символу с учетом ссылок неудачи
+    int32_t step(int32_t s, unsigned char c) const {
+        while (s != 0) {
+            int32_t t = child(s, c);
+            if (t >= 0) return t;
+            s = fail[s];
+        }
+        return rootNext[c];
+    }
+
+    // Все слова, заканчивающиеся в состоянии s: visit(длина слова)
+    template <class Visit>
+    void forEachOutput(int32_t s, Visit visit) const {
+        if (!endOfWord[s]) s = output[s];
+        for (; s >= 0; s = output[s]) {
+            visit(depth[s]);
+        }
+    }
+
+    size_t stateCount() const {
+        return labels.size();
+    }
+
+    size_t memoryBytes() const {
+        return firstChild.size() * sizeof(int32_t) + labels.size() + fail.size() * sizeof(int32_t)
+            + output.size() * sizeof(int32_t) + depth.size() * sizeof(uint32_t) + endOfWord.size()
+            + sizeof(rootNext);
+    }
+
+    // Потоковый поиск: текст подается кусками, состояние и позиция сохраняются между ними,
+    // поэтому найдутся и слова, разрезанные границей кусков. Автомат должен жить дольше сканера.
+    class Scanner {
+    private:
+        const AhoCorasick* automaton;
+        int32_t state = 0;
+        size_t position = 0;  // Байт потока, прочитанных до сих пор
+
+    public:
+        explicit Scanner(const AhoCorasick& automaton) : automaton(&automaton) {}
+
+        // callback(начало, длина) для каждого вхождения; начало отсчитывается от начала потока
+        template <class Callback>
+        void scan(std::string_view chunk, Callback callback) {
+            for (char ch : chunk) {
+                state = automaton->step(state, static_cast<unsigned char>(ch));
+                position++;
+                automaton->forEachOutput(state, [&](uint32_t length) {
+                    callback(position - length, static_cast<size_t>(length));
+                });
+            }
+        }
+
+        // Начало нового потока
+        void reset() {
+            state = 0;
+            position = 0;
+        }
+
+        size_t consumed() const {
+            return position;
+        }
+    };
+
+    Scanner scanner() const {
+        return Scanner(*this);
+    }
+
+    // Поиск во всем тексте сразу
+    template <class Callback>
+    void scan(std::string_view text, Callback callback) const {
+        Scanner whole(*this);
+        whole.scan(text, callback);
+    }
+};
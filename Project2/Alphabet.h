@@ -0,0 +1,75 @@
+﻿#pragma once
+#include <array>
+#include <string_view>
+
+// Алфавит узла-массива: таблица байт -> номер ячейки, строится при компиляции.
+// Ячейки идут по возрастанию байтов, поэтому обход детей по ячейкам
+// дает слова в лексикографическом порядке.
+
+struct AlphabetTable {
+    std::array<short, 256> slots{};            // Номер ячейки байта или -1
+    std::array<short, 256> lower{};            // Первая ячейка с байтом >= данного
+    std::array<unsigned char, 256> symbols{};  // Байт ячейки
+    int size = 0;
+};
+
+// Таблица по отметкам present[байт]
+constexpr AlphabetTable makeAlphabetTable(const std::array<bool, 256>& present) {
+    AlphabetTable table;
+    for (int b = 0; b < 256; b++) {
+        table.lower[b] = static_cast<short>(table.size);
+        table.slots[b] = -1;
+        if (present[b]) {
+            table.slots[b] = static_cast<short>(table.size);
+            table.symbols[table.size] = static_cast<unsigned char>(b);
+            table.size++;
+        }
+    }
+    return table;
+}
+
+// Байты из диапазона [first, last] и байты строки extra
+constexpr AlphabetTable makeAlphabet(unsigned char first, unsigned char last, std::string_view extra = {}) {
+    std::array<bool, 256> present{};
+    for (int b = first; b <= last; b++) present[b] = true;
+    for (char c : extra) present[static_cast<unsigned char>(c)] = true;
+    return makeAlphabetTable(present);
+}
+
+// Плотный алфавит по образцу текста: только встретившиеся в corpus байты
+constexpr AlphabetTable makeAlphabet(std::string_view corpus) {
+    std::array<bool, 256> present{};
+    for (char c : corpus) present[static_cast<unsigned char>(c)] = true;
+    return makeAlphabetTable(present);
+}
+
+template <AlphabetTable Table>
+struct Alphabet {
+    static_assert(Table.size > 0, "Пустой алфавит");
+    static constexpr int SIZE = Table.size;
+
+    // Номер ячейки символа или -1, если символа нет в алфавите
+    static constexpr int slot(char c) {
+        return Table.slots[static_cast<unsigned char>(c)];
+    }
+    // Первая ячейка с символом не меньше c (SIZE, если таких нет)
+    static constexpr int lowerSlot(char c) {
+        return Table.lower[static_cast<unsigned char>(c)];
+    }
+    static constexpr char symbol(int slot) {
+        return static_cast<char>(Table.symbols[slot]);
+    }
+};
+
+// Строчная латиница a-z
+using LatinAlphabet = Alphabet<makeAlphabet('a', 'z')>;
+
+// Строчная кириллица в Windows-1251 (кодировка консоли после setlocale "Russian"): а-я и ё
+using CyrillicAlphabet = Alphabet<makeAlphabet(0xE0, 0xFF, "\xB8")>;
+
+// Все 7-битные символы ASCII
+using AsciiAlphabet = Alphabet<makeAlphabet(0x00, 0x7F)>;
+
+// Алфавит по образцу: using Keys = DenseAlphabet<makeAlphabet("...текст корпуса...")>;
+template <AlphabetTable Table>
+using DenseAlphabet = Alphabet<Table>;
@@ -0,0 +1,198 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Арена: выдает память под узлы из больших непрерывных блоков.
+// Все дерево освобождается сразу через reset(); отдельный узел можно вернуть
+// через destroy(), его память попадет в список свободных и достанется следующему
+// create() того же размера.
+class Arena {
+public:
+    explicit Arena(size_t blockSize = 1 << 20) : blockSize(blockSize) {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() {
+        release();
+    }
+
+    template <class T, class... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value,
+            "Арена не вызывает деструкторы узлов");
+        void* p = freeLists.empty() ? nullptr : takeFree(sizeof(T), alignof(T));
+        if (!p) p = allocate(sizeof(T), alignof(T));
+        return new (p) T(std::forward<Args>(args)...);
+    }
+
+    template <class T>
+    void destroy(T* object) {
+        static_assert(sizeof(T) >= sizeof(FreeSlot), "Объект меньше указателя списка свободных");
+        FreeList& list = freeListFor(sizeof(T), alignof(T));
+        FreeSlot* slot = reinterpret_cast<FreeSlot*>(object);
+        slot->next = list.head;
+        list.head = slot;
+        list.count++;
+    }
+
+    void* allocate(size_t size, size_t align) {
+        size_t offset = (align - reinterpret_cast<size_t>(ptr) % align) % align;
+        while (!ptr || offset + size > static_cast<size_t>(end - ptr)) {
+            nextBlock(size + align);
+            offset = (align - reinterpret_cast<size_t>(ptr) % align) % align;
+        }
+        char* result = ptr + offset;
+        ptr = result + size;
+        used += offset + size;
+        return result;
+    }
+
+    // Освобождение всего дерева за O(1): блоки остаются для повторного использования
+    void reset() {
+        current = 0;
+        used = 0;
+        freeLists.clear();
+        if (blocks.empty()) {
+            ptr = end = nullptr;
+            return;
+        }
+        ptr = blocks[0].data;
+        end = ptr + blocks[0].size;
+    }
+
+    // Возврат всех блоков системе
+    void release() {
+        for (Block& block : blocks) {
+            std::free(block.data);
+        }
+        blocks.clear();
+        reserved = 0;
+        reset();
+    }
+
+    // Присоединение блоков другой арены (например, потоковой) вместе с узлами в них.
+    // Блоки встают перед текущим и освобождаются вместе с этой ареной.
+    void absorb(Arena& other) {
+        if (&other == this || other.blocks.empty()) return;
+        size_t count = other.current + 1;  // Остальные блоки other после reset() пусты
+        if (!other.ptr) count = 0;
+        blocks.insert(blocks.begin() + current, other.blocks.begin(), other.blocks.begin() + count);
+        for (size_t i = 0; i < count; i++) {
+            reserved += other.blocks[i].size;
+        }
+        if (ptr) {
+            current += count;
+        }
+        else {
+            current = blocks.size();
+        }
+        used += other.used;
+        for (FreeList& list : other.freeLists) {
+            while (list.head) {
+                FreeSlot* slot = list.head;
+                list.head = slot->next;
+                FreeList& own = freeListFor(list.size, list.align);
+                slot->next = own.head;
+                own.head = slot;
+                own.count++;
+            }
+        }
+        for (size_t i = count; i < other.blocks.size(); i++) {
+            std::free(other.blocks[i].data);
+        }
+        other.blocks.clear();
+        other.reserved = 0;
+        other.reset();
+    }
+
+    size_t bytesUsed() const { return used; }
+
+    // Память, взятая у системы блоками (то, что видно в RSS)
+    size_t bytesReserved() const { return reserved; }
+
+    // Число запросов блоков у системы за все время
+    size_t systemAllocations() const { return blockAllocations; }
+
+    // Байт в списках свободных
+    size_t bytesFree() const {
+        size_t total = 0;
+        for (const FreeList& list : freeLists) {
+            total += list.count * list.size;
+        }
+        return total;
+    }
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    // Свободные объекты одного размера и выравнивания; таких списков обычно 1-3
+    struct FreeList {
+        size_t size;
+        size_t align;
+        FreeSlot* head;
+        size_t count;
+    };
+
+    FreeList& freeListFor(size_t size, size_t align) {
+        for (FreeList& list : freeLists) {
+            if (list.size == size && list.align == align) return list;
+        }
+        freeLists.push_back({ size, align, nullptr, 0 });
+        return freeLists.back();
+    }
+
+    void* takeFree(size_t size, size_t align) {
+        for (FreeList& list : freeLists) {
+            if (list.size == size && list.align == align && list.head) {
+                FreeSlot* slot = list.head;
+                list.head = slot->next;
+                list.count--;
+                return slot;
+            }
+        }
+        return nullptr;
+    }
+
+    void nextBlock(size_t minSize) {
+        // Сначала пробуем блоки, оставшиеся после reset()
+        if (ptr) {
+            current++;
+        }
+        while (current < blocks.size() && blocks[current].size < minSize) {
+            current++;
+        }
+        if (current >= blocks.size()) {
+            size_t size = minSize > blockSize ? minSize : blockSize;
+            char* data = static_cast<char*>(std::malloc(size));
+            if (!data) throw std::bad_alloc();
+            blocks.push_back({ data, size });
+            reserved += size;
+            blockAllocations++;
+            current = blocks.size() - 1;
+        }
+        ptr = blocks[current].data;
+        end = ptr + blocks[current].size;
+    }
+
+    std::vector<Block> blocks;
+    std::vector<FreeList> freeLists;
+    size_t current = 0;
+    char* ptr = nullptr;
+    char* end = nullptr;
+    size_t blockSize;
+    size_t used = 0;
+    size_t reserved = 0;
+    size_t blockAllocations = 0;
+};
@@ -0,0 +1,330 @@
+﻿#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include "AhoCorasick.h"
+#include "Alphabet.h"
+#include "Arena.h"
+#include "Autocomplete.h"
+#include "BasicTrie.h"
+#include "Cursor.h"
+#include "Fuzzy.h"
+#include "LoudsTrie.h"
+#include "Parallel.h"
+#include "Prefetch.h"
+#include "TrieStats.h"
+
+// Способ с массивом
+
+// Узел хранит ячейку для каждого символа алфавита Alphabet (см. Alphabet.h)
+template <class Alphabet>
+struct BasicTrieNodeArray {
+    BasicTrieNodeArray* children[Alphabet::SIZE];
+    bool isEndOfWord;
+    unsigned short childCount;
+    uint32_t weight;     // Вес слова для автодополнения
+    uint32_t maxWeight;  // Наибольший вес слова в поддереве
+
+    BasicTrieNodeArray() : isEndOfWord(false), childCount(0), weight(0), maxWeight(0) {
+        for (int i = 0; i < Alphabet::SIZE; i++)
+            children[i] = nullptr;
+    }
+};
+
+using TrieNodeArray = BasicTrieNodeArray<LatinAlphabet>;
+
+// Упорядоченный обход слов для TrieCursor: позиция - номер ячейки children
+template <class Alphabet>
+struct ArrayCursorTraits {
+    using Node = BasicTrieNodeArray<Alphabet>;
+    using Pos = int;
+
+    static int skipEmpty(Node* node, int pos) {
+        while (pos < Alphabet::SIZE && !node->children[pos]) pos++;
+        return pos;
+    }
+    static int first(Node* node) { return skipEmpty(node, 0); }
+    static int lowerBound(Node* node, char ch) { return skipEmpty(node, Alphabet::lowerSlot(ch)); }
+    static bool valid(Node*, int pos) { return pos < Alphabet::SIZE; }
+    static int next(Node* node, int pos) { return skipEmpty(node, pos + 1); }
+    static char label(Node*, int pos) { return Alphabet::symbol(pos); }
+    static Node* child(Node* node, int pos) { return node->children[pos]; }
+    static bool isEnd(Node* node) { return node->isEndOfWord; }
+};
+
+// Раскладка узла-массива для BasicTrie
+template <class Alphabet>
+struct ArrayNodePolicy {
+    using Node = BasicTrieNodeArray<Alphabet>;
+    using CursorTraits = ArrayCursorTraits<Alphabet>;
+    static constexpr size_t CHILD_BYTES = sizeof(Node);
+
+    static bool accepts(char ch) { return Alphabet::slot(ch) >= 0; }
+    static Node* findChild(Node* node, char ch) { return node->children[Alphabet::slot(ch)]; }
+
+    template <class Alloc>
+    static Node* addChild(Node* node, char ch, Alloc& alloc) {
+        Node* child = alloc.template create<Node>();
+        node->children[Alphabet::slot(ch)] = child;
+        node->childCount++;
+        return child;
+    }
+
+    // Отсоединение ребенка с символом ch; сам ребенок не освобождается
+    template <class Alloc>
+    static void removeChild(Node* node, char ch, Alloc&) {
+        node->children[Alphabet::slot(ch)] = nullptr;
+        node->childCount--;
+    }
+
+    template <class Visit>
+    static void forEachChild(Node* node, Visit visit) {
+        for (int i = 0; i < Alphabet::SIZE; i++) {
+            if (node->children[i]) visit(Alphabet::symbol(i), node->children[i]);
+        }
+    }
+};
+
+template <class Alphabet = LatinAlphabet, class Alloc = Arena>
+using BasicArrayTrie = BasicTrie<ArrayNodePolicy<Alphabet>, Alloc>;
+using ArrayTrie = BasicArrayTrie<LatinAlphabet>;
+
+inline TrieNodeArray* root = nullptr;  // Глобальная переменная для корня
+inline Arena arrayArena;  // Арена по умолчанию для узлов массива
+inline TrieStats arrayStats;  // Счетчики дерева с корнем root
+
+template <class Alphabet = LatinAlphabet>
+BasicTrieNodeArray<Alphabet>* getNode(Arena& arena = arrayArena) {
+    return arena.create<BasicTrieNodeArray<Alphabet>>();
+}
+
+// Новое пустое дерево: корень и обнуленные счетчики
+template <class Alphabet = LatinAlphabet>
+BasicTrieNodeArray<Alphabet>* newTrie(TrieStats& stats = arrayStats, Arena& arena = arrayArena) {
+    stats = TrieStats();
+    stats.memoryBytes = sizeof(BasicTrieNodeArray<Alphabet>);
+    return getNode<Alphabet>(arena);
+}
+
+// Вставка символов key[from..] ниже узла node (nodeIsRoot - node является корнем).
+// Слово с символом вне алфавита не вставляется, возвращается false.
+template <class Alphabet>
+bool insertFrom(BasicTrieNodeArray<Alphabet>* node, const std::string& key, size_t from, bool nodeIsRoot,
+    TrieStats& stats, Arena& arena) {
+    return BasicArrayTrie<Alphabet>::insertFrom(node, key, from, nodeIsRoot, stats, arena);
+}
+
+template <class Alphabet>
+bool insert(BasicTrieNodeArray<Alphabet>* root, const std::string& key,
+    TrieStats& stats = arrayStats, Arena& arena = arrayArena) {
+    return insertFrom(root, key, 0, true, stats, arena);
+}
+
+// Параллельное построение: поддерево каждой первой буквы строит отдельный поток
+// в своей арене, затем поддеревья подвешиваются к корню, а арены - к arena
+template <class Alphabet = LatinAlphabet>
+BasicTrieNodeArray<Alphabet>* buildParallel(const std::vector<std::string>& words, unsigned threads = defaultThreadCount(),
+    TrieStats& stats = arrayStats, Arena& arena = arrayArena) {
+    using Node = BasicTrieNodeArray<Alphabet>;
+    Node* root = newTrie<Alphabet>(stats, arena);
+    std::vector<std::vector<const std::string*>> buckets = partitionByFirstChar(words);
+
+    std::vector<std::unique_ptr<Arena>> arenas;
+    for (unsigned i = 0; i < std::max(threads, 1u); i++) {
+        arenas.emplace_back(new Arena());
+    }
+    std::vector<Node*> subtrees(Alphabet::SIZE, nullptr);
+    std::vector<TrieStats> partial(Alphabet::SIZE);
+    parallelFor(Alphabet::SIZE, threads, [&](unsigned worker, size_t index) {
+        const std::vector<const std::string*>& bucket = buckets[static_cast<unsigned char>(Alphabet::symbol(static_cast<int>(index)))];
+        if (bucket.empty()) return;
+        Arena& local = *arenas[worker];
+        Node* subtree = getNode<Alphabet>(local);
+        for (const std::string* word : bucket) {
+            insertFrom(subtree, *word, 1, false, partial[index], local);
+        }
+        subtrees[index] = subtree;
+    });
+
+    for (int i = 0; i < Alphabet::SIZE; i++) {
+        if (!subtrees[i]) continue;
+        stats.onChildAdded(root->childCount, true, sizeof(Node));
+        root->childCount++;
+        root->children[i] = subtrees[i];
+        stats += partial[i];
+    }
+    for (std::unique_ptr<Arena>& local : arenas) {
+        arena.absorb(*local);
+    }
+    for (const std::string& word : words) {
+        if (word.empty() && !root->isEndOfWord) {
+            root->isEndOfWord = true;
+            stats.words++;
+        }
+    }
+    return root;
+}
+
+// Обход детей узла для обобщенных алгоритмов
+template <class Alphabet, class Visit>
+void forEachChild(BasicTrieNodeArray<Alphabet>* node, Visit visit) {
+    ArrayNodePolicy<Alphabet>::forEachChild(node, visit);
+}
+
+// Вставка слова с весом для автодополнения (повторная вставка меняет вес)
+template <class Alphabet>
+bool insert(BasicTrieNodeArray<Alphabet>* root, const std::string& key, uint32_t weight,
+    TrieStats& stats = arrayStats, Arena& arena = arrayArena) {
+    using Node = BasicTrieNodeArray<Alphabet>;
+    if (!insertFrom(root, key, 0, true, stats, arena)) return false;
+    std::vector<Node*> path;
+    path.push_back(root);
+    for (char c : key) {
+        path.push_back(path.back()->children[Alphabet::slot(c)]);
+    }
+    path.back()->weight = weight;
+    updateMaxWeights(path, [](Node* node, auto visit) { forEachChild(node, visit); });
+    return true;
+}
+
+// k слов с наибольшим весом среди начинающихся с prefix
+template <class Alphabet>
+std::vector<Completion> complete(BasicTrieNodeArray<Alphabet>* root, const std::string& prefix, size_t k) {
+    using Node = BasicTrieNodeArray<Alphabet>;
+    Node* pCrawl = root;
+    for (char c : prefix) {
+        int index = Alphabet::slot(c);
+        if (index < 0 || !pCrawl->children[index]) {
+            return {};
+        }
+        pCrawl = pCrawl->children[index];
+    }
+    return topCompletions(pCrawl, prefix, k, [](Node* node, auto visit) { forEachChild(node, visit); });
+}
+
+// Слова на расстоянии Левенштейна не больше maxEdits от word
+template <class Alphabet>
+std::vector<FuzzyMatch> searchFuzzy(BasicTrieNodeArray<Alphabet>* root, const std::string& word, int maxEdits) {
+    using Node = BasicTrieNodeArray<Alphabet>;
+    return fuzzyMatches(root, word, maxEdits, [](Node* node, auto visit) { forEachChild(node, visit); });
+}
+
+template <class Alphabet>
+bool search(BasicTrieNodeArray<Alphabet>* root, const std::string& key) {
+    BasicTrieNodeArray<Alphabet>* node = BasicArrayTrie<Alphabet>::find(root, key);
+    return node && node->isEndOfWord;
+}
+
+// Пакетный поиск: BATCH_GROUP поисков идут вперемешку по одному шагу,
+// для следующего узла каждого поиска заранее выдается prefetch, и пока
+// он загружается, выполняются шаги остальных поисков
+template <class Alphabet>
+void searchBatch(BasicTrieNodeArray<Alphabet>* root, std::span<const std::string> keys, std::span<bool> results) {
+    using Node = BasicTrieNodeArray<Alphabet>;
+    struct Lookup {
+        size_t key;  // Номер слова в keys
+        size_t pos;  // Номер следующего символа
+        Node* node;
+    };
+    Lookup group[BATCH_GROUP];
+    int active = 0;
+    size_t nextKey = 0;
+    for (; active < BATCH_GROUP && nextKey < keys.size(); active++, nextKey++) {
+        group[active] = { nextKey, 0, root };
+    }
+
+    while (active > 0) {
+        for (int g = 0; g < active;) {
+            Lookup& lookup = group[g];
+            const std::string& key = keys[lookup.key];
+            bool done = true;
+            if (lookup.pos == key.size()) {
+                results[lookup.key] = lookup.node->isEndOfWord;
+            }
+            else {
+                int index = Alphabet::slot(key[lookup.pos]);
+                Node* child = index >= 0 ? lookup.node->children[index] : nullptr;
+                if (!child) {
+                    results[lookup.key] = false;
+                }
+                else {
+                    lookup.node = child;
+                    lookup.pos++;
+                    // Строка кэша, которая понадобится на следующем шаге
+                    if (lookup.pos < key.size()) {
+                        int nextIndex = Alphabet::slot(key[lookup.pos]);
+                        if (nextIndex >= 0) prefetch(&child->children[nextIndex]);
+                    }
+                    else {
+                        prefetch(&child->isEndOfWord);
+                    }
+                    done = false;
+                }
+            }
+            if (!done) {
+                g++;
+            }
+            else if (nextKey < keys.size()) {
+                group[g] = { nextKey++, 0, root };  // Освободившееся место - следующему слову
+            }
+            else {
+                group[g] = group[--active];
+            }
+        }
+    }
+}
+
+// Все параметры дерева за один обход, при threads > 1 - параллельный
+template <class Alphabet>
+TrieStats collectStats(BasicTrieNodeArray<Alphabet>* root, unsigned threads = 1) {
+    if (!root) return TrieStats();
+    return BasicArrayTrie<Alphabet>::recount(root, threads);
+}
+
+// Функция для подсчета используемой памяти (счетчики ведутся в insert)
+inline size_t calculateMemoryUsage(const TrieStats& stats = arrayStats) {
+    return stats.memoryBytes;
+}
+
+// Заморозка дерева в неизменяемое сжатое представление LOUDS
+template <class Alphabet>
+LoudsTrie freeze(BasicTrieNodeArray<Alphabet>* root) {
+    using Node = BasicTrieNodeArray<Alphabet>;
+    return LoudsTrie::build(root,
+        [](Node* node, std::vector<std::pair<char, Node*>>& out) {
+            for (int i = 0; i < Alphabet::SIZE; i++) {
+                if (node->children[i]) out.push_back({ Alphabet::symbol(i), node->children[i] });
+            }
+        },
+        [](Node* node) { return node->isEndOfWord; });
+}
+
+// Автомат Ахо-Корасик для поиска всех слов дерева в тексте
+template <class Alphabet>
+AhoCorasick automaton(BasicTrieNodeArray<Alphabet>* root) {
+    using Node = BasicTrieNodeArray<Alphabet>;
+    return AhoCorasick::build(root,
+        [](Node* node, std::vector<std::pair<char, Node*>>& out) {
+            forEachChild(node, [&](char ch, Node* child) { out.push_back({ ch, child }); });
+        },
+        [](Node* node) { return node->isEndOfWord; });
+}
+
+template <class Alphabet = LatinAlphabet>
+using ArrayCursor = TrieCursor<ArrayCursorTraits<Alphabet>>;
+
+// Слова >= from по порядку
+template <class Alphabet>
+ArrayCursor<Alphabet> cursor(BasicTrieNodeArray<Alphabet>* root, const std::string& from = std::string()) {
+    return ArrayCursor<Alphabet>(root, from);
+}
+
+// Слова из [from, to) по порядку
+template <class Alphabet>
+ArrayCursor<Alphabet> cursor(BasicTrieNodeArray<Alphabet>* root, const std::string& from, const std::string& to) {
+    return ArrayCursor<Alphabet>(root, from, to);
+}
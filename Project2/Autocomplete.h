@@ -0,0 +1,77 @@
+﻿#pragma once
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <vector>
+
+// Автодополнение по весам: в концах слов хранится вес слова, в каждом узле -
+// наибольший вес в его поддереве (maxWeight). Узлы перебираются в порядке
+// убывания maxWeight, поэтому поиск останавливается после k-го найденного слова.
+
+struct Completion {
+    std::string word;
+    uint32_t weight;
+};
+
+// forEachChild(node, visit) вызывает visit(символ, ребенок) для всех детей node
+template <class Node, class ForEachChild>
+std::vector<Completion> topCompletions(Node* start, const std::string& prefix, size_t k,
+    ForEachChild forEachChild) {
+    std::vector<Completion> result;
+    if (!start || k == 0) return result;
+
+    // Путь к узлу хранится ссылкой на родителя, строка собирается только для ответа
+    struct Trail {
+        size_t parent;
+        char ch;
+    };
+    struct Entry {
+        uint32_t bound;  // Вес слова или maxWeight поддерева
+        bool isWord;     // Слова выдаются раньше поддеревьев с тем же весом
+        Node* node;
+        size_t trail;
+        bool operator<(const Entry& other) const {
+            if (bound != other.bound) return bound < other.bound;
+            return !isWord && other.isWord;
+        }
+    };
+    const size_t NO_TRAIL = static_cast<size_t>(-1);
+    std::vector<Trail> trails;
+    std::priority_queue<Entry> queue;
+    queue.push({ start->maxWeight, false, start, NO_TRAIL });
+
+    while (!queue.empty() && result.size() < k) {
+        Entry entry = queue.top();
+        queue.pop();
+        if (entry.isWord) {
+            std::string suffix;
+            for (size_t t = entry.trail; t != NO_TRAIL; t = trails[t].parent) {
+                suffix += trails[t].ch;
+            }
+            result.push_back({ prefix + std::string(suffix.rbegin(), suffix.rend()), entry.bound });
+            continue;
+        }
+        if (entry.node->isEndOfWord) {
+            queue.push({ entry.node->weight, true, entry.node, entry.trail });
+        }
+        forEachChild(entry.node, [&](char ch, Node* child) {
+            trails.push_back({ entry.trail, ch });
+            queue.push({ child->maxWeight, false, child, trails.size() - 1 });
+        });
+    }
+    return result;
+}
+
+// Пересчет maxWeight снизу вверх по пути от корня к слову, вес которого изменился
+template <class Node, class ForEachChild>
+void updateMaxWeights(const std::vector<Node*>& path, ForEachChild forEachChild) {
+    for (size_t i = path.size(); i > 0; i--) {
+        Node* node = path[i - 1];
+        uint32_t best = node->isEndOfWord ? node->weight : 0;
+        forEachChild(node, [&](char, Node* child) {
+            if (child->maxWeight > best) best = child->maxWeight;
+        });
+        if (best == node->maxWeight && i < path.size()) break;  // Выше ничего не изменится
+        node->maxWeight = best;
+    }
+}
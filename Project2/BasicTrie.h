@@ -0,0 +1,318 @@
+﻿#pragma once
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "AhoCorasick.h"
+#include "Arena.h"
+#include "Autocomplete.h"
+#include "Cursor.h"
+#include "Fuzzy.h"
+#include "Instrument.h"
+#include "Parallel.h"
+#include "TrieStats.h"
+
+// Общий движок префиксного дерева: вставка, поиск и параметры написаны один раз,
+// раскладка узла задается политикой NodePolicy. Все функции политики статические,
+// поэтому поиск ребенка встраивается для каждой раскладки.
+//
+// NodePolicy:
+//   Node                       - узел с полями isEndOfWord и childCount
+//   CursorTraits               - обход детей для TrieCursor
+//   CHILD_BYTES                - память, добавляемая с каждым новым ребенком
+//   accepts(ch)                - допустим ли символ в слове
+//   findChild(node, ch)        - ребенок по допустимому символу или nullptr
+//   addChild(node, ch, alloc)  - новый ребенок (увеличивает childCount)
+//   removeChild(node, ch, alloc) - отсоединение ребенка (уменьшает childCount)
+//   forEachChild(node, visit)  - visit(символ, ребенок) по возрастанию символа
+// Alloc выделяет узлы через create<T>(), возвращает по одному через destroy()
+// и освобождает все сразу через reset(), как Arena.
+template <class NodePolicy, class Alloc = Arena>
+class BasicTrie {
+public:
+    using Node = typename NodePolicy::Node;
+    using Cursor = TrieCursor<typename NodePolicy::CursorTraits>;
+
+protected:
+    std::unique_ptr<Alloc> ownAlloc;  // Собственный распределитель, если внешний не передан
+    Alloc* alloc;
+    TrieStats counters;  // Параметры дерева, обновляются в insert
+
+    void resetCounters() {
+        counters = TrieStats();
+        counters.memoryBytes = sizeof(Node);
+    }
+
+    // Поля узла, кроме детей
+    static void copyPayload(Node* to, const Node* from) {
+        to->isEndOfWord = from->isEndOfWord;
+        if constexpr (requires(Node* node) { node->weight; node->maxWeight; }) {
+            to->weight = from->weight;
+            to->maxWeight = from->maxWeight;
+        }
+    }
+
+    // Возврат всех узлов поддерева распределителю
+    void destroyTree(Node* start) {
+        std::vector<Node*> stack;
+        std::vector<char> labels;
+        stack.push_back(start);
+        while (!stack.empty()) {
+            Node* node = stack.back();
+            stack.pop_back();
+            labels.clear();
+            NodePolicy::forEachChild(node, [&](char ch, Node* child) {
+                labels.push_back(ch);
+                stack.push_back(child);
+            });
+            for (char ch : labels) {
+                NodePolicy::removeChild(node, ch, *alloc);
+            }
+            alloc->destroy(node);
+        }
+    }
+
+public:
+    Node* root;
+
+    explicit BasicTrie(Alloc* externalAlloc = nullptr) {
+        if (!externalAlloc) {
+            ownAlloc.reset(new Alloc());
+            externalAlloc = ownAlloc.get();
+        }
+        alloc = externalAlloc;
+        root = alloc->template create<Node>();
+        resetCounters();
+    }
+
+    // Собственный распределитель освобождается целиком; узлы во внешнем
+    // возвращаются в его списки свободных и достанутся другим деревьям.
+    // Внешний распределитель общий, поэтому reset() для него не вызывается.
+    ~BasicTrie() {
+        if (!ownAlloc) destroyTree(root);
+    }
+
+    BasicTrie(const BasicTrie&) = delete;
+    BasicTrie& operator=(const BasicTrie&) = delete;
+
+    // Освобождение всех узлов: за O(1) в собственном распределителе,
+    // по одному - во внешнем
+    void clear() {
+        if (ownAlloc) alloc->reset();
+        else destroyTree(root);
+        root = alloc->template create<Node>();
+        resetCounters();
+    }
+
+    // Вставка символов word[from..] ниже узла node (nodeIsRoot - node является корнем).
+    // Слово с недопустимым символом не вставляется, возвращается false.
+    static bool insertFrom(Node* node, const std::string& word, size_t from, bool nodeIsRoot,
+        TrieStats& stats, Alloc& alloc) {
+        TRIE_PROBE(ProbeOp::Insert);
+        for (size_t i = from; i < word.size(); i++) {
+            if (!NodePolicy::accepts(word[i])) return false;
+        }
+        Node* current = node;
+        bool isRoot = nodeIsRoot;
+        for (size_t i = from; i < word.size(); i++) {
+            char ch = word[i];
+            Node* child = NodePolicy::findChild(current, ch);
+            if (!child) {
+                stats.onChildAdded(current->childCount, isRoot, NodePolicy::CHILD_BYTES);
+                child = NodePolicy::addChild(current, ch, alloc);
+            }
+            current = child;
+            isRoot = false;
+            TRIE_PROBE_NODE();
+        }
+        if (!current->isEndOfWord) {
+            stats.words++;
+            current->isEndOfWord = true;
+        }
+        return true;
+    }
+
+    bool insert(const std::string& word) {
+        return insertFrom(root, word, 0, true, counters, *alloc);
+    }
+
+    // Удаление слова. Узлы, после которых не осталось слов, отсоединяются
+    // и возвращаются распределителю. false, если слова не было.
+    bool erase(const std::string& word) {
+        std::vector<Node*> path;
+        path.reserve(word.size() + 1);
+        path.push_back(root);
+        for (char ch : word) {
+            if (!NodePolicy::accepts(ch)) return false;
+            Node* child = NodePolicy::findChild(path.back(), ch);
+            if (!child) return false;
+            path.push_back(child);
+        }
+        if (!path.back()->isEndOfWord) return false;
+        path.back()->isEndOfWord = false;
+        counters.words--;
+
+        for (size_t depth = word.size(); depth > 0; depth--) {
+            Node* node = path[depth];
+            if (node->isEndOfWord || node->childCount > 0) break;
+            Node* parent = path[depth - 1];
+            NodePolicy::removeChild(parent, word[depth - 1], *alloc);
+            counters.onChildRemoved(parent->childCount, depth == 1, NodePolicy::CHILD_BYTES);
+            alloc->destroy(node);
+            path.pop_back();
+        }
+
+        if constexpr (requires(Node* node) { node->weight; node->maxWeight; }) {
+            if (path.size() == word.size() + 1) path.back()->weight = 0;
+            updateMaxWeights(path, [](Node* node, auto visit) { NodePolicy::forEachChild(node, visit); });
+        }
+        return true;
+    }
+
+    // Перенос живых узлов в новый распределитель подряд: дети каждого узла
+    // лежат рядом, свободные места и хвосты блоков после удалений исчезают.
+    // Дальше дерево владеет новым распределителем; внешний больше не используется.
+    void compact() {
+        std::unique_ptr<Alloc> fresh(new Alloc());
+        Node* copy = fresh->template create<Node>();
+        copyPayload(copy, root);
+        std::vector<std::pair<Node*, Node*>> stack;
+        stack.push_back({ root, copy });
+        while (!stack.empty()) {
+            std::pair<Node*, Node*> top = stack.back();
+            stack.pop_back();
+            NodePolicy::forEachChild(top.first, [&](char ch, Node* child) {
+                Node* childCopy = NodePolicy::addChild(top.second, ch, *fresh);
+                copyPayload(childCopy, child);
+                stack.push_back({ child, childCopy });
+            });
+        }
+        if (!ownAlloc) destroyTree(root);
+        ownAlloc = std::move(fresh);
+        alloc = ownAlloc.get();
+        root = copy;
+    }
+
+    // Узел, в котором заканчивается путь word от start, или nullptr
+    static Node* find(Node* start, const std::string& word) {
+        TRIE_PROBE(ProbeOp::Search);
+        Node* current = start;
+        for (char ch : word) {
+            if (!NodePolicy::accepts(ch)) return nullptr;
+            current = NodePolicy::findChild(current, ch);
+            if (!current) return nullptr;
+            TRIE_PROBE_NODE();
+        }
+        return current;
+    }
+
+    bool search(const std::string& word) const {
+        Node* node = find(root, word);
+        return node && node->isEndOfWord;
+    }
+
+    // Слова на расстоянии Левенштейна не больше maxEdits от word, по порядку
+    std::vector<FuzzyMatch> searchFuzzy(const std::string& word, int maxEdits) const {
+        return fuzzyMatches(root, word, maxEdits,
+            [](Node* node, auto visit) { NodePolicy::forEachChild(node, visit); });
+    }
+
+    // Автомат Ахо-Корасик для поиска всех слов дерева в тексте; дерево после
+    // построения можно менять, автомат от него не зависит
+    AhoCorasick automaton() const {
+        return AhoCorasick::build(root,
+            [](Node* node, std::vector<std::pair<char, Node*>>& out) {
+                NodePolicy::forEachChild(node, [&](char ch, Node* child) { out.push_back({ ch, child }); });
+            },
+            [](Node* node) { return node->isEndOfWord; });
+    }
+
+    // Параметры дерева без обхода
+    const TrieStats& stats() const {
+        return counters;
+    }
+
+    size_t calculateMemoryUsage() const {
+        return counters.memoryBytes;
+    }
+
+    // Пересчет всех параметров дерева с корнем start за один обход;
+    // при threads > 1 поддеревья обходятся параллельно (parallelTreeReduce)
+    static TrieStats recount(Node* start, unsigned threads = 1) {
+        TrieStats result = parallelTreeReduce<TrieStats>(start,
+            [](Node* node, auto visit) { NodePolicy::forEachChild(node, visit); },
+            [](Node* node, size_t depth, size_t children, TrieStats& partial) {
+                if (node->isEndOfWord) partial.words++;
+                if (depth == 0) return;
+                partial.totalNodes++;
+                if (children == 0) return;
+                partial.internalNodes++;
+                if (children > 1) {
+                    partial.branchingNodes++;
+                    partial.branchingPaths += static_cast<int>(children);
+                    partial.pathBranchings++;
+                }
+            },
+            threads);
+        result.memoryBytes = sizeof(Node) + result.totalNodes * NodePolicy::CHILD_BYTES;
+        return result;
+    }
+
+    TrieStats recount(unsigned threads = 1) const {
+        return recount(root, threads);
+    }
+
+    // Узлы и ветвление по глубинам за один обход
+    static ShapeHistogram shape(Node* start, unsigned threads = 1) {
+        return parallelTreeReduce<ShapeHistogram>(start,
+            [](Node* node, auto visit) { NodePolicy::forEachChild(node, visit); },
+            [](Node*, size_t depth, size_t children, ShapeHistogram& partial) {
+                partial.add(depth, children);
+            },
+            threads);
+    }
+
+    ShapeHistogram shape(unsigned threads = 1) const {
+        return shape(root, threads);
+    }
+
+    // Распределитель узлов, например для счетчиков CountingArena
+    const Alloc& allocator() const {
+        return *alloc;
+    }
+
+    // Слова >= from по порядку, без сборки всего списка
+    Cursor cursor(const std::string& from = std::string()) const {
+        return Cursor(root, from);
+    }
+
+    // Слова из [from, to) по порядку
+    Cursor cursor(const std::string& from, const std::string& to) const {
+        return Cursor(root, from, to);
+    }
+
+    // 1. Общее количество символов
+    int totalChars() const {
+        return counters.totalNodes;
+    }
+
+    // 2. Количество слов (листовых вершин в дереве)
+    int wordCount() const {
+        return counters.words;
+    }
+
+    // 3. Количество внутренних вершин
+    int internalNodeCount() const {
+        return counters.internalNodes;
+    }
+
+    // 4. Количество ветвлений (внутренних вершин из которых более одного пути)
+    int branchingNodeCount() const {
+        return counters.branchingNodes;
+    }
+
+    // 5. Среднее количество путей в вершинах ветвлений
+    double averageBranchingPaths() const {
+        return counters.avgBranching();
+    }
+};
@@ -0,0 +1,405 @@
+﻿// Воспроизводимый замер всех способов: построение, поиск, подсчет параметров и память
+// на словарях от 10^3 до 10^8 символов. Результат - JSON или CSV для сравнения между запусками.
+//
+// trie_benchmark [--min-chars N] [--max-chars N] [--reps N] [--warmup N] [--seed N]
+//                [--variants array,list,...] [--format json|csv] [--out файл]
+//
+// Размеры - степени 10 от min-chars до max-chars. Слова одинаковы при одинаковом seed.
+// Каждая операция выполняется warmup раз без учета, затем reps раз с замером;
+// в отчет идут минимум, медиана и среднее в наносекундах.
+// Сборка с -DTRIE_INSTRUMENT=ON дополнительно выводит в stderr перцентили задержек
+// insert/search/getChild, посещенные узлы, шаги по спискам и счетчики perf (Linux).
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AdaptiveTrie.h"
+#include "ArrayTrie.h"
+#include "BurstTrie.h"
+#include "ConcurrentTrie.h"
+#include "Dawg.h"
+#include "DoubleArrayTrie.h"
+#include "Instrument.h"
+#include "ListTrie.h"
+#include "Parallel.h"
+#include "LoudsTrie.h"
+#include "RadixTrie.h"
+#include "TrieStats.h"
+#include "Words.h"
+
+struct BenchOptions {
+    long long minChars = 1000;
+    long long maxChars = 1000000;  // До 10^8 - через --max-chars 100000000
+    int reps = 5;
+    int warmup = 1;
+    unsigned seed = 42;
+    std::vector<std::string> variants;  // Пусто - все способы
+    std::string format = "json";
+    std::string out;
+};
+
+struct BenchResult {
+    std::string variant;
+    std::string op;       // build, search, stats, stats_parallel
+    long long chars;
+    size_t words;
+    size_t ops;           // Операций в одном замере (слов при построении и поиске)
+    double minNs;
+    double medianNs;
+    double meanNs;
+    size_t memoryBytes;
+    TrieStats stats;
+};
+
+// Результат поиска накапливается здесь, чтобы компилятор не выбросил поиск
+volatile size_t benchSink = 0;
+
+// warmup + reps запусков run; before вызывается перед каждым запуском и не замеряется
+std::vector<double> measure(const BenchOptions& options, const std::function<void()>& before,
+    const std::function<void()>& run) {
+    std::vector<double> samples;
+    for (int i = 0; i < options.warmup + options.reps; i++) {
+        before();
+        auto start = std::chrono::steady_clock::now();
+        run();
+        auto end = std::chrono::steady_clock::now();
+        if (i >= options.warmup) {
+            samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        }
+    }
+    return samples;
+}
+
+BenchResult summarize(const std::string& variant, const std::string& op, long long chars, size_t words,
+    size_t ops, std::vector<double> samples, const TrieStats& stats) {
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (double sample : samples) sum += sample;
+    size_t middle = samples.size() / 2;
+    double median = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+    return { variant, op, chars, words, ops, samples.front(), median, sum / samples.size(),
+        stats.memoryBytes, stats };
+}
+
+// Замер участка run (вызовов measure); при TRIE_INSTRUMENT в stderr выводятся
+// распределения по операциям и аппаратные счетчики на операцию
+template <class Run>
+std::vector<double> probed(const BenchOptions& options, const char* name, const char* op, long long chars,
+    size_t ops, Run run) {
+#ifdef TRIE_INSTRUMENT
+    ProbeRegistry::instance().reset();
+    PerfCounters perf;
+    perf.start();
+    std::vector<double> samples = run();
+    PerfCounters::Sample hardware = perf.stop();
+    double total = static_cast<double>(ops) * (options.warmup + options.reps);
+    std::cerr << name << " " << op << ", " << chars << " символов:\n";
+    printProbes(std::cerr, ProbeRegistry::instance().snapshot());
+    if (perf.available() && total > 0) {
+        std::cerr << "  на операцию: инструкций " << hardware.instructions / total
+            << ", промахов кэша " << hardware.cacheMisses / total << "\n";
+    }
+    return samples;
+#else
+    (void)options, (void)name, (void)op, (void)chars, (void)ops;
+    return run();
+#endif
+}
+
+// Способ для замера: build строит структуру из слов, search ищет одно слово,
+// stats - полный подсчет параметров, если он есть, иначе снимок счетчиков;
+// parallelStats, если есть, - тот же подсчет на всех ядрах (операция stats_parallel)
+template <class Variant>
+void runVariant(const BenchOptions& options, const char* name, long long chars,
+    const std::vector<std::string>& words, const std::vector<std::string>& queries,
+    std::vector<BenchResult>& results) {
+    std::unique_ptr<typename Variant::Type> trie;
+    std::vector<double> samples = probed(options, name, "build", chars, words.size(), [&] {
+        return measure(options,
+            [&] { trie.reset(); },
+            [&] { trie = Variant::build(words); });
+    });
+    TrieStats stats = Variant::stats(*trie);
+    results.push_back(summarize(name, "build", chars, words.size(), words.size(), samples, stats));
+
+    samples = probed(options, name, "search", chars, queries.size(), [&] {
+        return measure(options, [] {}, [&] {
+            size_t found = 0;
+            for (const std::string& query : queries) {
+                found += Variant::search(*trie, query);
+            }
+            benchSink = benchSink + found;
+        });
+    });
+    results.push_back(summarize(name, "search", chars, words.size(), queries.size(), samples, stats));
+
+    samples = measure(options, [] {}, [&] {
+        benchSink = benchSink + Variant::stats(*trie).totalNodes;
+    });
+    results.push_back(summarize(name, "stats", chars, words.size(), 1, samples, stats));
+
+    if constexpr (requires(const typename Variant::Type& built) { Variant::parallelStats(built); }) {
+        samples = measure(options, [] {}, [&] {
+            benchSink = benchSink + Variant::parallelStats(*trie).totalNodes;
+        });
+        results.push_back(summarize(name, "stats_parallel", chars, words.size(), 1, samples, stats));
+    }
+}
+
+struct ArrayVariant {
+    using Type = ArrayTrie;
+    static std::unique_ptr<Type> build(const std::vector<std::string>& words) {
+        std::unique_ptr<Type> trie(new Type());
+        for (const std::string& word : words) trie->insert(word);
+        return trie;
+    }
+    static bool search(const Type& trie, const std::string& word) { return trie.search(word); }
+    static TrieStats stats(const Type& trie) { return trie.recount(); }
+    static TrieStats parallelStats(const Type& trie) { return trie.recount(defaultThreadCount()); }
+};
+
+struct ListVariant {
+    using Type = Trie;
+    static std::unique_ptr<Type> build(const std::vector<std::string>& words) {
+        std::unique_ptr<Type> trie(new Type());
+        for (const std::string& word : words) trie->insert(word);
+        return trie;
+    }
+    static bool search(const Type& trie, const std::string& word) { return trie.search(word); }
+    static TrieStats stats(const Type& trie) { return trie.recount(); }
+    static TrieStats parallelStats(const Type& trie) { return trie.recount(defaultThreadCount()); }
+};
+
+struct AdaptiveVariant {
+    using Type = AdaptiveTrie;
+    static std::unique_ptr<Type> build(const std::vector<std::string>& words) {
+        std::unique_ptr<Type> trie(new Type());
+        for (const std::string& word : words) trie->insert(word);
+        return trie;
+    }
+    static bool search(const Type& trie, const std::string& word) { return trie.search(word); }
+    static TrieStats stats(const Type& trie) { return trie.stats(); }
+};
+
+struct RadixVariant {
+    using Type = RadixTrie;
+    static std::unique_ptr<Type> build(const std::vector<std::string>& words) {
+        std::unique_ptr<Type> trie(new Type());
+        for (const std::string& word : words) trie->insert(word);
+        return trie;
+    }
+    static bool search(const Type& trie, const std::string& word) { return trie.search(word); }
+    static TrieStats stats(Type& trie) { return trie.recount(); }
+};
+
+struct BurstVariant {
+    using Type = BurstTrie;
+    static std::unique_ptr<Type> build(const std::vector<std::string>& words) {
+        std::unique_ptr<Type> trie(new Type());
+        for (const std::string& word : words) trie->insert(word);
+        return trie;
+    }
+    static bool search(const Type& trie, const std::string& word) { return trie.search(word); }
+    static TrieStats stats(const Type& trie) { return trie.recount(); }
+};
+
+// Сжатое дерево, построенное сразу из всего набора
+struct RadixBulkVariant : RadixVariant {
+    static std::unique_ptr<Type> build(const std::vector<std::string>& words) {
+        std::unique_ptr<Type> trie(new Type());
+        trie->build(words);
+        return trie;
+    }
+};
+
+// Построение LOUDS включает построение дерева со списками и заморозку
+struct LoudsVariant {
+    using Type = LoudsTrie;
+    static std::unique_ptr<Type> build(const std::vector<std::string>& words) {
+        Trie source;
+        for (const std::string& word : words) source.insert(word);
+        return std::unique_ptr<Type>(new Type(source.freeze()));
+    }
+    static bool search(const Type& trie, const std::string& word) { return trie.search(word); }
+    static TrieStats stats(const Type& trie) { return trie.stats(); }
+};
+
+struct DoubleArrayVariant {
+    using Type = DoubleArrayTrie;
+    static std::unique_ptr<Type> build(const std::vector<std::string>& words) {
+        std::unique_ptr<Type> trie(new Type());
+        trie->build(words);
+        return trie;
+    }
+    static bool search(const Type& trie, const std::string& word) { return trie.search(word); }
+    static TrieStats stats(const Type& trie) { return trie.stats(); }
+};
+
+struct DawgVariant {
+    using Type = Dawg;
+    static std::unique_ptr<Type> build(const std::vector<std::string>& words) {
+        std::unique_ptr<Type> trie(new Type());
+        trie->build(words);
+        return trie;
+    }
+    static bool search(const Type& trie, const std::string& word) { return trie.search(word); }
+    static TrieStats stats(const Type& trie) { return trie.stats(); }
+};
+
+// Один писатель: стоимость атомарных операций без конкуренции
+struct ConcurrentVariant {
+    using Type = ConcurrentTrie;
+    static std::unique_ptr<Type> build(const std::vector<std::string>& words) {
+        std::unique_ptr<Type> trie(new Type());
+        ConcurrentTrie::Writer writer = trie->writer();
+        for (const std::string& word : words) writer.insert(word);
+        return trie;
+    }
+    static bool search(const Type& trie, const std::string& word) { return trie.search(word); }
+    static TrieStats stats(const Type& trie) { return trie.stats(); }
+};
+
+struct VariantEntry {
+    const char* name;
+    void (*run)(const BenchOptions&, const char*, long long, const std::vector<std::string>&,
+        const std::vector<std::string>&, std::vector<BenchResult>&);
+};
+
+const VariantEntry VARIANTS[] = {
+    { "array", runVariant<ArrayVariant> },
+    { "list", runVariant<ListVariant> },
+    { "burst", runVariant<BurstVariant> },
+    { "adaptive", runVariant<AdaptiveVariant> },
+    { "radix", runVariant<RadixVariant> },
+    { "radix_bulk", runVariant<RadixBulkVariant> },
+    { "louds", runVariant<LoudsVariant> },
+    { "double_array", runVariant<DoubleArrayVariant> },
+    { "dawg", runVariant<DawgVariant> },
+    { "concurrent", runVariant<ConcurrentVariant> },
+};
+
+bool selected(const BenchOptions& options, const std::string& name) {
+    return options.variants.empty() ||
+        std::find(options.variants.begin(), options.variants.end(), name) != options.variants.end();
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find(',', start);
+        if (end == std::string::npos) end = text.size();
+        if (end > start) parts.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+    return parts;
+}
+
+bool parseOptions(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Нет значения для " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--min-chars") options.minChars = std::atoll(value.c_str());
+        else if (arg == "--max-chars") options.maxChars = std::atoll(value.c_str());
+        else if (arg == "--reps") options.reps = std::atoi(value.c_str());
+        else if (arg == "--warmup") options.warmup = std::atoi(value.c_str());
+        else if (arg == "--seed") options.seed = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+        else if (arg == "--variants") options.variants = splitList(value);
+        else if (arg == "--format") options.format = value;
+        else if (arg == "--out") options.out = value;
+        else {
+            std::cerr << "Неизвестный параметр " << arg << "\n";
+            return false;
+        }
+    }
+    if (options.minChars < 1 || options.maxChars < options.minChars || options.reps < 1 || options.warmup < 0 ||
+        (options.format != "json" && options.format != "csv")) {
+        std::cerr << "Недопустимые параметры\n";
+        return false;
+    }
+    for (const std::string& name : options.variants) {
+        bool known = false;
+        for (const VariantEntry& entry : VARIANTS) known = known || name == entry.name;
+        if (!known) {
+            std::cerr << "Неизвестный способ " << name << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+void writeCsv(std::ostream& out, const std::vector<BenchResult>& results) {
+    out << "variant,op,chars,words,ops,min_ns,median_ns,mean_ns,ns_per_op,memory_bytes,"
+        "total_nodes,internal_nodes,branching_nodes,avg_branching\n";
+    for (const BenchResult& r : results) {
+        out << r.variant << ',' << r.op << ',' << r.chars << ',' << r.words << ',' << r.ops << ','
+            << r.minNs << ',' << r.medianNs << ',' << r.meanNs << ',' << r.medianNs / r.ops << ','
+            << r.memoryBytes << ',' << r.stats.totalNodes << ',' << r.stats.internalNodes << ','
+            << r.stats.branchingNodes << ',' << r.stats.avgBranching() << '\n';
+    }
+}
+
+void writeJson(std::ostream& out, const BenchOptions& options, const std::vector<BenchResult>& results) {
+    out << "{\n  \"seed\": " << options.seed << ",\n  \"reps\": " << options.reps
+        << ",\n  \"warmup\": " << options.warmup << ",\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"variant\": \"" << r.variant << "\", \"op\": \"" << r.op
+            << "\", \"chars\": " << r.chars << ", \"words\": " << r.words << ", \"ops\": " << r.ops
+            << ", \"min_ns\": " << r.minNs << ", \"median_ns\": " << r.medianNs << ", \"mean_ns\": " << r.meanNs
+            << ", \"ns_per_op\": " << r.medianNs / r.ops << ", \"memory_bytes\": " << r.memoryBytes
+            << ", \"total_nodes\": " << r.stats.totalNodes << ", \"internal_nodes\": " << r.stats.internalNodes
+            << ", \"branching_nodes\": " << r.stats.branchingNodes
+            << ", \"avg_branching\": " << r.stats.avgBranching() << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+
+    std::vector<BenchResult> results;
+    for (long long chars = options.minChars; chars <= options.maxChars; chars *= 10) {
+        std::vector<std::string> words;
+        generateWords(words, 4, 8, static_cast<int>(chars), options.seed);
+        // Запросы: все слова словаря и столько же других слов, большей частью отсутствующих
+        std::vector<std::string> queries;
+        generateWords(queries, 4, 8, static_cast<int>(chars), options.seed + 1);
+        queries.insert(queries.end(), words.begin(), words.end());
+
+        for (const VariantEntry& entry : VARIANTS) {
+            if (!selected(options, entry.name)) continue;
+            std::cerr << entry.name << ", " << chars << " символов\n";
+            entry.run(options, entry.name, chars, words, queries, results);
+        }
+    }
+
+    std::ofstream file;
+    if (!options.out.empty()) {
+        file.open(options.out);
+        if (!file) {
+            std::cerr << "Не удалось открыть " << options.out << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = options.out.empty() ? std::cout : file;
+    out << std::fixed << std::setprecision(3);
+    if (options.format == "csv") writeCsv(out, results);
+    else writeJson(out, options, results);
+    return 0;
+}
@@ -0,0 +1,316 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Arena.h"
+#include "TrieStats.h"
+
+// Гибрид дерева и корзин (burst trie / HAT-trie): верхние уровни - узлы с массивом
+// на 256 байт, а редкие хвосты ниже хранятся в корзинах - подряд уложенных
+// отсортированных суффиксах. Поиск по корзине идет по одному непрерывному куску
+// памяти вместо цепочки узлов. Корзина, в которой стало больше BURST_LIMIT строк,
+// "взрывается": заменяется узлом, а суффиксы раскладываются по новым корзинам
+// по первому символу.
+
+// Корзина: суффиксы по возрастанию, перед каждым - длина (байт, для длинных 0xFF и 4 байта)
+struct BurstBucket {
+    std::string packed;
+    uint32_t count = 0;
+};
+
+// Элемент массива узла: 0, указатель на узел или на корзину с меткой в младшем бите
+struct BurstNode {
+    uintptr_t slots[256];
+    bool isEndOfWord;
+
+    BurstNode() : slots(), isEndOfWord(false) {}
+};
+
+class BurstTrie {
+public:
+    static const uint32_t BURST_LIMIT = 128;  // Строк в корзине до взрыва
+
+private:
+    std::unique_ptr<Arena> ownArena;  // Собственная арена, если внешняя не передана
+    Arena* arena;
+    size_t words = 0;
+    size_t nodes = 0;    // Узлы дерева, включая корень
+    size_t buckets = 0;
+
+    static bool isBucket(uintptr_t slot) { return slot & 1; }
+    static BurstNode* asNode(uintptr_t slot) { return reinterpret_cast<BurstNode*>(slot); }
+    static BurstBucket* asBucket(uintptr_t slot) { return reinterpret_cast<BurstBucket*>(slot & ~uintptr_t(1)); }
+    static uintptr_t tag(BurstBucket* bucket) { return reinterpret_cast<uintptr_t>(bucket) | 1; }
+
+    static size_t readLength(const char*& p) {
+        unsigned char first = static_cast<unsigned char>(*p++);
+        if (first < 0xFF) return first;
+        uint32_t length;
+        std::memcpy(&length, p, sizeof(length));
+        p += sizeof(length);
+        return length;
+    }
+
+    static void appendEntry(std::string& packed, std::string_view suffix) {
+        packed += encodeEntry(suffix);
+    }
+
+    static std::string encodeEntry(std::string_view suffix) {
+        std::string entry;
+        if (suffix.size() < 0xFF) {
+            entry.push_back(static_cast<char>(suffix.size()));
+        }
+        else {
+            uint32_t length = static_cast<uint32_t>(suffix.size());
+            entry.push_back(static_cast<char>(0xFF));
+            entry.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        }
+        entry.append(suffix.data(), suffix.size());
+        return entry;
+    }
+
+    // Обход суффиксов корзины по порядку: visit(суффикс, смещение записи);
+    // visit возвращает false, чтобы остановиться
+    template <class Visit>
+    static void forEachEntry(const BurstBucket& bucket, Visit visit) {
+        const char* begin = bucket.packed.data();
+        const char* end = begin + bucket.packed.size();
+        for (const char* p = begin; p < end;) {
+            size_t offset = p - begin;
+            size_t length = readLength(p);
+            if (!visit(std::string_view(p, length), offset)) return;
+            p += length;
+        }
+    }
+
+    // Смещение суффикса в корзине или места для его вставки; found - есть ли он
+    static size_t locate(const BurstBucket& bucket, std::string_view suffix, bool& found) {
+        size_t position = bucket.packed.size();
+        found = false;
+        forEachEntry(bucket, [&](std::string_view entry, size_t offset) {
+            int order = entry.compare(suffix);
+            if (order < 0) return true;
+            found = order == 0;
+            position = offset;
+            return false;
+        });
+        return position;
+    }
+
+    BurstBucket* newBucket() {
+        buckets++;
+        return new BurstBucket();
+    }
+
+    // Замена корзины узлом; суффиксы идут по порядку, поэтому новые корзины
+    // заполняются дописыванием в конец. Переполненные дети взрываются следом.
+    BurstNode* burst(BurstBucket* bucket) {
+        BurstNode* node = arena->create<BurstNode>();
+        nodes++;
+        forEachEntry(*bucket, [&](std::string_view suffix, size_t) {
+            if (suffix.empty()) {
+                node->isEndOfWord = true;
+                return true;
+            }
+            uintptr_t& slot = node->slots[static_cast<unsigned char>(suffix[0])];
+            if (!slot) slot = tag(newBucket());
+            BurstBucket* child = asBucket(slot);
+            appendEntry(child->packed, suffix.substr(1));
+            child->count++;
+            return true;
+        });
+        delete bucket;
+        buckets--;
+        for (uintptr_t& slot : node->slots) {
+            if (slot && asBucket(slot)->count > BURST_LIMIT) {
+                slot = reinterpret_cast<uintptr_t>(burst(asBucket(slot)));
+            }
+        }
+        return node;
+    }
+
+    // Удаление корзин; узлы внешней арены возвращаются в ее списки свободных,
+    // собственная освобождается целиком
+    void releaseTree() {
+        std::vector<BurstNode*> stack;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            BurstNode* node = stack.back();
+            stack.pop_back();
+            for (uintptr_t slot : node->slots) {
+                if (!slot) continue;
+                if (isBucket(slot)) delete asBucket(slot);
+                else stack.push_back(asNode(slot));
+            }
+            if (!ownArena) arena->destroy(node);
+        }
+    }
+
+    // Параметры поддерева, которое заменяет корзина (корень поддерева - сам символ слота)
+    static void countBucket(const BurstBucket& bucket, TrieStats& result) {
+        std::vector<std::string_view> suffixes;
+        suffixes.reserve(bucket.count);
+        forEachEntry(bucket, [&](std::string_view suffix, size_t) {
+            suffixes.push_back(suffix);
+            return true;
+        });
+
+        struct Task {
+            size_t lo, hi;  // Суффиксы [lo, hi) проходят через узел
+            size_t depth;
+        };
+        std::vector<Task> stack;
+        stack.push_back({ 0, suffixes.size(), 0 });
+        while (!stack.empty()) {
+            Task task = stack.back();
+            stack.pop_back();
+            size_t i = task.lo;
+            if (i < task.hi && suffixes[i].size() == task.depth) {
+                result.words++;  // Короткий суффикс идет первым
+                i++;
+            }
+            int children = 0;
+            while (i < task.hi) {
+                size_t start = i;
+                char ch = suffixes[i][task.depth];
+                while (i < task.hi && suffixes[i][task.depth] == ch) i++;
+                stack.push_back({ start, i, task.depth + 1 });
+                children++;
+            }
+            result.totalNodes++;
+            if (children > 0) result.internalNodes++;
+            if (children > 1) {
+                result.branchingNodes++;
+                result.branchingPaths += children;
+                result.pathBranchings++;
+            }
+        }
+    }
+
+public:
+    BurstNode* root;
+
+    explicit BurstTrie(Arena* externalArena = nullptr) {
+        if (!externalArena) {
+            ownArena.reset(new Arena());
+            externalArena = ownArena.get();
+        }
+        arena = externalArena;
+        root = arena->create<BurstNode>();
+        nodes = 1;
+    }
+
+    ~BurstTrie() {
+        releaseTree();
+    }
+
+    BurstTrie(const BurstTrie&) = delete;
+    BurstTrie& operator=(const BurstTrie&) = delete;
+
+    // Освобождение всех узлов: за O(1) в собственной арене, по одному - во внешней
+    // (она общая и не сбрасывается); корзины - по одной
+    void clear() {
+        releaseTree();
+        if (ownArena) arena->reset();
+        root = arena->create<BurstNode>();
+        words = 0;
+        nodes = 1;
+        buckets = 0;
+    }
+
+    // false, если слово уже было
+    bool insert(const std::string& word) {
+        BurstNode* node = root;
+        for (size_t i = 0; i < word.size(); i++) {
+            uintptr_t& slot = node->slots[static_cast<unsigned char>(word[i])];
+            if (slot && !isBucket(slot)) {
+                node = asNode(slot);
+                continue;
+            }
+            if (!slot) slot = tag(newBucket());
+            BurstBucket* bucket = asBucket(slot);
+            std::string_view suffix = std::string_view(word).substr(i + 1);
+            bool found;
+            size_t position = locate(*bucket, suffix, found);
+            if (found) return false;
+            bucket->packed.insert(position, encodeEntry(suffix));
+            bucket->count++;
+            words++;
+            if (bucket->count > BURST_LIMIT) {
+                slot = reinterpret_cast<uintptr_t>(burst(bucket));
+            }
+            return true;
+        }
+        if (node->isEndOfWord) return false;
+        node->isEndOfWord = true;
+        words++;
+        return true;
+    }
+
+    bool search(const std::string& word) const {
+        BurstNode* node = root;
+        for (size_t i = 0; i < word.size(); i++) {
+            uintptr_t slot = node->slots[static_cast<unsigned char>(word[i])];
+            if (!slot) return false;
+            if (isBucket(slot)) {
+                bool found;
+                locate(*asBucket(slot), std::string_view(word).substr(i + 1), found);
+                return found;
+            }
+            node = asNode(slot);
+        }
+        return node->isEndOfWord;
+    }
+
+    size_t wordCount() const {
+        return words;
+    }
+
+    // Узлы дерева, включая корень
+    size_t nodeCount() const {
+        return nodes;
+    }
+
+    size_t bucketCount() const {
+        return buckets;
+    }
+
+    // Пять параметров - как у префиксного дерева с теми же словами,
+    // память - фактическая: узлы и корзины с их строками
+    TrieStats recount() const {
+        TrieStats result;
+        result.memoryBytes = nodes * sizeof(BurstNode);
+        std::vector<BurstNode*> stack;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            BurstNode* node = stack.back();
+            stack.pop_back();
+            if (node->isEndOfWord) result.words++;
+            int children = 0;
+            for (uintptr_t slot : node->slots) {
+                if (!slot) continue;
+                children++;
+                if (isBucket(slot)) {
+                    BurstBucket* bucket = asBucket(slot);
+                    result.memoryBytes += sizeof(BurstBucket) + bucket->packed.capacity();
+                    countBucket(*bucket, result);
+                }
+                else {
+                    stack.push_back(asNode(slot));
+                }
+            }
+            if (node == root) continue;
+            result.totalNodes++;
+            if (children > 0) result.internalNodes++;
+            if (children > 1) {
+                result.branchingNodes++;
+                result.branchingPaths += children;
+                result.pathBranchings++;
+            }
+        }
+        return result;
+    }
+};
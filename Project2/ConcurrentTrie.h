@@ -0,0 +1,152 @@
+﻿#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Alphabet.h"
+#include "Arena.h"
+#include "TrieStats.h"
+
+// Способ с массивом для многопоточной работы: дети хранятся в атомарных
+// ячейках и устанавливаются через compare-and-swap, блокировок нет.
+// search() выполняется за длину слова шагов при любом числе писателей.
+// Ячейки детей - по алфавиту Alphabet (см. Alphabet.h); слово с символом
+// вне алфавита не вставляется и не находится.
+
+template <class Alphabet>
+struct BasicConcurrentNode {
+    std::atomic<BasicConcurrentNode*> children[Alphabet::SIZE];
+    std::atomic<bool> isEndOfWord;
+    std::atomic<uint16_t> childCount;
+
+    BasicConcurrentNode() : isEndOfWord(false), childCount(0) {
+        for (int i = 0; i < Alphabet::SIZE; i++)
+            children[i].store(nullptr, std::memory_order_relaxed);
+    }
+};
+
+using ConcurrentNode = BasicConcurrentNode<LatinAlphabet>;
+
+template <class Alphabet = LatinAlphabet>
+class BasicConcurrentTrie {
+public:
+    using Node = BasicConcurrentNode<Alphabet>;
+
+private:
+    Arena rootArena;
+    std::mutex writersMutex;  // Только для регистрации писателей, не для вставки
+    std::vector<std::unique_ptr<Arena>> writerArenas;
+
+    // Параметры дерева, обновляются атомарно в insert
+    std::atomic<int> totalNodes{ 0 };
+    std::atomic<int> words{ 0 };
+    std::atomic<int> internalNodes{ 0 };
+    std::atomic<int> branchingNodes{ 0 };
+    std::atomic<int> branchingPaths{ 0 };
+
+    // То же, что TrieStats::onChildAdded; childCount - значение до добавления,
+    // fetch_add выдает каждому писателю свое, поэтому итог не зависит от гонок
+    void countChildAdded(int childCount, bool parentIsRoot) {
+        totalNodes.fetch_add(1, std::memory_order_relaxed);
+        if (parentIsRoot) return;
+        if (childCount == 0) {
+            internalNodes.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (childCount == 1) {
+            branchingNodes.fetch_add(1, std::memory_order_relaxed);
+            branchingPaths.fetch_add(2, std::memory_order_relaxed);
+        }
+        else {
+            branchingPaths.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    Node* const root;
+
+    // Писатель: своя арена на поток. Узел, проигравший гонку CAS,
+    // остается у писателя и используется при следующей вставке.
+    class Writer {
+    private:
+        BasicConcurrentTrie* trie;
+        Arena* arena;
+        Node* spare = nullptr;
+
+    public:
+        Writer(BasicConcurrentTrie* trie, Arena* arena) : trie(trie), arena(arena) {}
+
+        // Слово с символом вне алфавита не вставляется, возвращается false
+        bool insert(const std::string& word) {
+            for (char c : word) {
+                if (Alphabet::slot(c) < 0) return false;
+            }
+            Node* current = trie->root;
+            for (char c : word) {
+                int index = Alphabet::slot(c);
+                Node* child = current->children[index].load(std::memory_order_acquire);
+                if (!child) {
+                    Node* fresh = spare ? spare : arena->template create<Node>();
+                    spare = nullptr;
+                    if (current->children[index].compare_exchange_strong(child, fresh,
+                        std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        int before = current->childCount.fetch_add(1, std::memory_order_relaxed);
+                        trie->countChildAdded(before, current == trie->root);
+                        child = fresh;
+                    }
+                    else {
+                        spare = fresh;  // child - узел, вставленный другим потоком
+                    }
+                }
+                current = child;
+            }
+            if (!current->isEndOfWord.exchange(true, std::memory_order_acq_rel)) {
+                trie->words.fetch_add(1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+    };
+
+    BasicConcurrentTrie() : root(rootArena.template create<Node>()) {}
+
+    BasicConcurrentTrie(const BasicConcurrentTrie&) = delete;
+    BasicConcurrentTrie& operator=(const BasicConcurrentTrie&) = delete;
+
+    // Писатель для текущего потока; один писатель нельзя делить между потоками
+    Writer writer() {
+        std::lock_guard<std::mutex> lock(writersMutex);
+        writerArenas.emplace_back(new Arena(1 << 16));
+        return Writer(this, writerArenas.back().get());
+    }
+
+    bool search(const std::string& word) const {
+        const Node* current = root;
+        for (char c : word) {
+            int index = Alphabet::slot(c);
+            if (index < 0) {
+                return false;
+            }
+            current = current->children[index].load(std::memory_order_acquire);
+            if (!current) {
+                return false;
+            }
+        }
+        return current->isEndOfWord.load(std::memory_order_acquire);
+    }
+
+    // Снимок параметров; при активных писателях значения могут отставать
+    TrieStats stats() const {
+        TrieStats result;
+        result.totalNodes = totalNodes.load(std::memory_order_relaxed);
+        result.words = words.load(std::memory_order_relaxed);
+        result.internalNodes = internalNodes.load(std::memory_order_relaxed);
+        result.branchingNodes = branchingNodes.load(std::memory_order_relaxed);
+        result.branchingPaths = branchingPaths.load(std::memory_order_relaxed);
+        result.pathBranchings = result.branchingNodes;
+        result.memoryBytes = (result.totalNodes + 1) * sizeof(Node);
+        return result;
+    }
+};
+
+using ConcurrentTrie = BasicConcurrentTrie<LatinAlphabet>;
@@ -0,0 +1,100 @@
+﻿#pragma once
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include "Arena.h"
+
+// Счетчики распределителя. В отличие от TrieStats::memoryBytes (сумма sizeof узлов),
+// здесь видны потери на выравнивание и недоиспользованные блоки.
+struct MemoryStats {
+    size_t liveBytes = 0;          // Занято живыми объектами (sizeof)
+    size_t peakLiveBytes = 0;
+    size_t liveObjects = 0;
+    size_t allocations = 0;        // Создано объектов за все время
+    size_t frees = 0;              // Освобождено объектов за все время
+    size_t paddingBytes = 0;       // Потеряно на выравнивание между живыми объектами
+    size_t reservedBytes = 0;      // Взято у системы блоками
+    size_t peakReservedBytes = 0;
+    size_t systemAllocations = 0;  // Запросов блоков у системы
+
+    // Часть блоков, которая ничем не занята (хвосты блоков, освобожденные объекты, блоки после reset())
+    size_t unusedBytes() const {
+        return reservedBytes - liveBytes - paddingBytes;
+    }
+};
+
+// Арена со счетчиками: тот же интерфейс, что у Arena, поэтому подставляется
+// в BasicTrie вместо нее (BasicTrie<NodePolicy, CountingArena>).
+class CountingArena {
+public:
+    explicit CountingArena(size_t blockSize = 1 << 20) : arena(blockSize) {}
+
+    CountingArena(const CountingArena&) = delete;
+    CountingArena& operator=(const CountingArena&) = delete;
+
+    template <class T, class... Args>
+    T* create(Args&&... args) {
+        size_t before = arena.bytesUsed();
+        T* result = arena.create<T>(std::forward<Args>(args)...);
+        size_t taken = arena.bytesUsed() - before;  // 0, если память взята из списка свободных
+        if (taken > sizeof(T)) slotPadding[result] = taken - sizeof(T);
+        counters.paddingBytes += padding(result);
+        counters.liveBytes += sizeof(T);
+        counters.liveObjects++;
+        counters.allocations++;
+        if (counters.liveBytes > counters.peakLiveBytes) counters.peakLiveBytes = counters.liveBytes;
+        updateReserved();
+        return result;
+    }
+
+    template <class T>
+    void destroy(T* object) {
+        counters.paddingBytes -= padding(object);
+        arena.destroy(object);
+        counters.liveBytes -= sizeof(T);
+        counters.liveObjects--;
+        counters.frees++;
+    }
+
+    void reset() {
+        arena.reset();
+        counters.frees += counters.liveObjects;
+        counters.liveObjects = 0;
+        counters.liveBytes = 0;
+        counters.paddingBytes = 0;
+        slotPadding.clear();
+    }
+
+    void release() {
+        reset();
+        arena.release();
+        updateReserved();
+    }
+
+    const MemoryStats& stats() const {
+        return counters;
+    }
+
+    size_t bytesUsed() const { return arena.bytesUsed(); }
+    size_t bytesFree() const { return arena.bytesFree(); }
+    size_t bytesReserved() const { return arena.bytesReserved(); }
+
+private:
+    // Выравнивание перед местом объекта; место из списка свободных сохраняет свое
+    size_t padding(const void* object) const {
+        auto found = slotPadding.find(object);
+        return found == slotPadding.end() ? 0 : found->second;
+    }
+
+    void updateReserved() {
+        counters.reservedBytes = arena.bytesReserved();
+        counters.systemAllocations = arena.systemAllocations();
+        if (counters.reservedBytes > counters.peakReservedBytes) {
+            counters.peakReservedBytes = counters.reservedBytes;
+        }
+    }
+
+    Arena arena;
+    MemoryStats counters;
+    std::unordered_map<const void*, size_t> slotPadding;  // Только места с ненулевым выравниванием
+};
@@ -0,0 +1,103 @@
+﻿#pragma once
+#include <string>
+#include <vector>
+
+// Курсор по словам дерева в лексикографическом порядке. Слова не материализуются:
+// текущее слово лежит в одном буфере, путь от корня - в явном стеке.
+//
+// Traits описывает способ хранения детей:
+//   Node, Pos                      - тип узла и позиции среди детей
+//   first(node)                    - позиция первого ребенка
+//   lowerBound(node, ch)           - первый ребенок с символом >= ch
+//   valid(node, pos), next(node, pos)
+//   label(node, pos), child(node, pos), isEnd(node)
+// Дети должны перебираться по возрастанию символа (как unsigned char).
+template <class Traits>
+class TrieCursor {
+private:
+    using Node = typename Traits::Node;
+    using Pos = typename Traits::Pos;
+
+    struct Frame {
+        Node* node;
+        Pos pos;        // Следующий непросмотренный ребенок
+        bool selfDone;  // Слово, заканчивающееся в node, уже выдано или меньше нижней границы
+    };
+
+    std::vector<Frame> stack;
+    std::string buffer;
+    std::string upper;
+    bool hasUpper = false;
+
+    static bool less(char a, char b) {
+        return static_cast<unsigned char>(a) < static_cast<unsigned char>(b);
+    }
+
+public:
+    // Курсор на первое слово >= from; при заданном to - только слова < to
+    TrieCursor(Node* root, const std::string& from = std::string()) {
+        seek(root, from);
+    }
+
+    TrieCursor(Node* root, const std::string& from, const std::string& to)
+        : upper(to), hasUpper(true) {
+        seek(root, from);
+    }
+
+    // Установка на первое слово >= from (lower_bound)
+    void seek(Node* root, const std::string& from) {
+        stack.clear();
+        buffer.clear();
+        stack.push_back({ root, Traits::first(root), false });
+        for (char ch : from) {
+            Frame& top = stack.back();
+            top.selfDone = true;  // Префиксы from меньше from
+            Pos pos = Traits::lowerBound(top.node, ch);
+            if (!Traits::valid(top.node, pos) || less(ch, Traits::label(top.node, pos))) {
+                top.pos = pos;  // Дальше from нет слов с этим префиксом
+                return;
+            }
+            Node* child = Traits::child(top.node, pos);
+            top.pos = Traits::next(top.node, pos);
+            buffer += ch;
+            stack.push_back({ child, Traits::first(child), false });
+        }
+    }
+
+    // Переход к следующему слову; false, если слова закончились
+    bool next() {
+        while (!stack.empty()) {
+            Frame& top = stack.back();
+            if (!top.selfDone) {
+                top.selfDone = true;
+                if (Traits::isEnd(top.node)) {
+                    if (hasUpper && buffer.compare(upper) >= 0) {
+                        stack.clear();
+                        return false;
+                    }
+                    return true;
+                }
+            }
+            if (Traits::valid(top.node, top.pos)) {
+                Pos pos = top.pos;
+                Node* child = Traits::child(top.node, pos);
+                buffer += Traits::label(top.node, pos);
+                if (hasUpper && buffer.compare(upper) >= 0) {
+                    stack.clear();  // Все слова поддерева не меньше буфера
+                    return false;
+                }
+                top.pos = Traits::next(top.node, pos);
+                stack.push_back({ child, Traits::first(child), false });
+                continue;
+            }
+            stack.pop_back();
+            if (!stack.empty()) buffer.pop_back();
+        }
+        return false;
+    }
+
+    // Текущее слово; действительно до следующего вызова next()
+    const std::string& key() const {
+        return buffer;
+    }
+};
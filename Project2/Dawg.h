@@ -0,0 +1,241 @@
+﻿#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Cursor.h"
+#include "TrieStats.h"
+
+// Минимальный ациклический автомат (DAWG): как дерево, но одинаковые поддеревья
+// (общие окончания вида "-ing", "-tion") хранятся один раз. Строится по одному
+// проходу отсортированных слов с минимизацией на лету: когда путь предыдущего слова
+// больше не может измениться, его узлы снизу вверх сверяются с реестром уже
+// готовых узлов, и повторы заменяются ссылками на найденные.
+
+struct DawgNode;
+
+struct DawgEdge {
+    DawgNode* target;
+    char ch;
+};
+
+struct DawgNode {
+    const DawgEdge* edges;  // Переходы по возрастанию символа
+    uint32_t edgeCount;
+    bool isEndOfWord;
+};
+
+struct DawgCursorTraits {
+    using Node = DawgNode;
+    using Pos = const DawgEdge*;
+
+    static const DawgEdge* first(DawgNode* node) { return node->edges; }
+    static const DawgEdge* lowerBound(DawgNode* node, char ch) {
+        return std::lower_bound(node->edges, node->edges + node->edgeCount, ch,
+            [](const DawgEdge& edge, char value) {
+                return static_cast<unsigned char>(edge.ch) < static_cast<unsigned char>(value);
+            });
+    }
+    static bool valid(DawgNode* node, const DawgEdge* pos) { return pos != node->edges + node->edgeCount; }
+    static const DawgEdge* next(DawgNode*, const DawgEdge* pos) { return pos + 1; }
+    static char label(DawgNode*, const DawgEdge* pos) { return pos->ch; }
+    static DawgNode* child(DawgNode*, const DawgEdge* pos) { return pos->target; }
+    static bool isEnd(DawgNode* node) { return node->isEndOfWord; }
+};
+
+using DawgCursor = TrieCursor<DawgCursorTraits>;
+
+class Dawg {
+private:
+    // Узел во время построения: переходы в номера узлов
+    struct Draft {
+        std::vector<std::pair<unsigned char, int32_t>> edges;
+        bool isEndOfWord = false;
+    };
+
+    // Ребро на пути последнего слова, узел child еще не сверен с реестром
+    struct Pending {
+        int32_t parent;
+        int32_t child;
+    };
+
+    std::vector<DawgNode> nodes;  // nodes[0] - корень
+    std::vector<DawgEdge> edges;
+    TrieStats counters;
+    size_t trieNodes = 0;
+
+    // Ключ реестра: признак конца слова и переходы в уже готовые узлы
+    static std::string signature(const Draft& draft) {
+        std::string key(1, draft.isEndOfWord ? '1' : '0');
+        for (const std::pair<unsigned char, int32_t>& edge : draft.edges) {
+            char target[sizeof(int32_t)];
+            std::memcpy(target, &edge.second, sizeof(int32_t));
+            key.push_back(static_cast<char>(edge.first));
+            key.append(target, sizeof(int32_t));
+        }
+        return key;
+    }
+
+    // Параметры дерева считаются по узлам до слияния: число детей узла
+    // не меняется, когда его переходы перенаправляются на найденные в реестре
+    void countNode(const Draft& draft, bool isRoot) {
+        if (draft.isEndOfWord) counters.words++;
+        if (isRoot) return;
+        int deg = static_cast<int>(draft.edges.size());
+        counters.totalNodes++;
+        if (deg > 0) counters.internalNodes++;
+        if (deg > 1) {
+            counters.branchingNodes++;
+            counters.branchingPaths += deg;
+            counters.pathBranchings++;
+        }
+    }
+
+public:
+    Dawg() {
+        build({});
+    }
+
+    // Узлы ссылаются на переходы в edges, поэтому автомат не копируется
+    Dawg(const Dawg&) = delete;
+    Dawg& operator=(const Dawg&) = delete;
+    Dawg(Dawg&&) = default;
+    Dawg& operator=(Dawg&&) = default;
+
+    // Построение из отсортированного списка слов (неотсортированный сортируется)
+    void build(std::vector<std::string> words) {
+        if (!std::is_sorted(words.begin(), words.end())) {
+            std::sort(words.begin(), words.end());
+        }
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+        counters = TrieStats();
+
+        std::vector<Draft> drafts(1);
+        std::vector<Pending> unchecked;
+        std::unordered_map<std::string, int32_t> registry;
+
+        // Сверка узлов пути последнего слова глубже depth с реестром
+        auto minimize = [&](size_t depth) {
+            while (unchecked.size() > depth) {
+                Pending top = unchecked.back();
+                unchecked.pop_back();
+                countNode(drafts[top.child], false);
+                auto found = registry.emplace(signature(drafts[top.child]), top.child);
+                if (!found.second) {
+                    drafts[top.parent].edges.back().second = found.first->second;  // Слова идут по порядку
+                    drafts[top.child] = Draft();
+                }
+            }
+        };
+
+        const std::string* previous = nullptr;
+        for (const std::string& word : words) {
+            size_t common = 0;
+            if (previous) {
+                size_t limit = std::min(previous->size(), word.size());
+                while (common < limit && (*previous)[common] == word[common]) common++;
+            }
+            minimize(common);
+            int32_t node = unchecked.empty() ? 0 : unchecked.back().child;
+            for (size_t i = common; i < word.size(); i++) {
+                int32_t child = static_cast<int32_t>(drafts.size());
+                drafts.emplace_back();
+                drafts[node].edges.push_back({ static_cast<unsigned char>(word[i]), child });
+                unchecked.push_back({ node, child });
+                node = child;
+            }
+            drafts[node].isEndOfWord = true;
+            previous = &word;
+        }
+        minimize(0);
+        countNode(drafts[0], true);
+        trieNodes = drafts.size();
+
+        // Перенумерация оставшихся узлов обходом в ширину и укладка переходов подряд
+        std::vector<int32_t> renumbered(drafts.size(), -1);
+        std::vector<int32_t> order;
+        size_t edgeTotal = 0;
+        renumbered[0] = 0;
+        order.push_back(0);
+        for (size_t head = 0; head < order.size(); head++) {
+            const Draft& draft = drafts[order[head]];
+            edgeTotal += draft.edges.size();
+            for (const std::pair<unsigned char, int32_t>& edge : draft.edges) {
+                if (renumbered[edge.second] < 0) {
+                    renumbered[edge.second] = static_cast<int32_t>(order.size());
+                    order.push_back(edge.second);
+                }
+            }
+        }
+        nodes.assign(order.size(), DawgNode());
+        edges.clear();
+        edges.reserve(edgeTotal);  // Без перевыделения: узлы хранят указатели на переходы
+        for (size_t i = 0; i < order.size(); i++) {
+            const Draft& draft = drafts[order[i]];
+            nodes[i].edges = edges.data() + edges.size();
+            nodes[i].edgeCount = static_cast<uint32_t>(draft.edges.size());
+            nodes[i].isEndOfWord = draft.isEndOfWord;
+            for (const std::pair<unsigned char, int32_t>& edge : draft.edges) {
+                edges.push_back({ &nodes[renumbered[edge.second]], static_cast<char>(edge.first) });
+            }
+        }
+        counters.memoryBytes = nodes.size() * sizeof(DawgNode) + edges.size() * sizeof(DawgEdge);
+    }
+
+    DawgNode* root() const {
+        return const_cast<DawgNode*>(nodes.data());
+    }
+
+    // Узел, в котором заканчивается путь prefix, или nullptr
+    DawgNode* descend(const std::string& prefix) const {
+        DawgNode* node = root();
+        for (char ch : prefix) {
+            const DawgEdge* pos = DawgCursorTraits::lowerBound(node, ch);
+            if (!DawgCursorTraits::valid(node, pos) || pos->ch != ch) return nullptr;
+            node = pos->target;
+        }
+        return node;
+    }
+
+    bool search(const std::string& word) const {
+        DawgNode* node = descend(word);
+        return node && node->isEndOfWord;
+    }
+
+    bool startsWith(const std::string& prefix) const {
+        return descend(prefix) != nullptr;
+    }
+
+    // Слова >= from по порядку
+    DawgCursor cursor(const std::string& from = std::string()) const {
+        return DawgCursor(root(), from);
+    }
+
+    // Слова из [from, to) по порядку
+    DawgCursor cursor(const std::string& from, const std::string& to) const {
+        return DawgCursor(root(), from, to);
+    }
+
+    // Узлы автомата, включая корень
+    size_t nodeCount() const {
+        return nodes.size();
+    }
+
+    // Узлы, которые заняло бы префиксное дерево с теми же словами, включая корень
+    size_t trieNodeCount() const {
+        return trieNodes;
+    }
+
+    size_t savedNodes() const {
+        return trieNodes - nodes.size();
+    }
+
+    // Пять параметров - как у префиксного дерева с теми же словами,
+    // память - фактическая память автомата
+    const TrieStats& stats() const {
+        return counters;
+    }
+};
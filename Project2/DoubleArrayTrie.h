@@ -0,0 +1,224 @@
+﻿#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TrieStats.h"
+
+// Способ с двойным массивом (base/check): переход из состояния s по коду c
+// ведет в t = base[s] + c, если check[t] == s. Код 0 отмечает конец слова,
+// символы кодируются как байт + 1. Корень - состояние 0.
+
+// Поиск по готовым массивам base/check: в памяти процесса или в отображенном файле
+struct DoubleArrayView {
+    const int32_t* base;
+    const int32_t* check;
+    size_t size;
+
+    static int code(char ch) {
+        return static_cast<unsigned char>(ch) + 1;
+    }
+
+    // Состояние после перехода по коду или -1
+    int32_t next(int32_t s, int c) const {
+        size_t t = static_cast<size_t>(base[s]) + c;
+        return (t < size && check[t] == s) ? static_cast<int32_t>(t) : -1;
+    }
+
+    int32_t descend(const std::string& prefix) const {
+        int32_t s = 0;
+        for (char ch : prefix) {
+            s = next(s, code(ch));
+            if (s < 0) return -1;
+        }
+        return s;
+    }
+
+    bool search(const std::string& word) const {
+        int32_t s = descend(word);
+        return s >= 0 && next(s, 0) >= 0;
+    }
+
+    // Есть ли слова с данным префиксом
+    bool startsWith(const std::string& prefix) const {
+        return descend(prefix) >= 0;
+    }
+
+    // Длины всех слов словаря, являющихся префиксами text (для токенизатора)
+    std::vector<size_t> prefixMatches(const std::string& text) const {
+        std::vector<size_t> lengths;
+        int32_t s = 0;
+        for (size_t i = 0;; i++) {
+            if (next(s, 0) >= 0) lengths.push_back(i);
+            if (i == text.size()) break;
+            s = next(s, code(text[i]));
+            if (s < 0) break;
+        }
+        return lengths;
+    }
+};
+
+class DoubleArrayTrie {
+private:
+    enum : int32_t {
+        FREE = -1,  // Пометка свободной ячейки в check
+        ROOT = -2   // Ячейка корня: ни одно состояние не ведет в нее
+    };
+
+    std::vector<int32_t> base;
+    std::vector<int32_t> check;
+    size_t firstFree = 1;  // Все ячейки левее заняты
+    TrieStats counters;
+
+    static int code(char ch) {
+        return DoubleArrayView::code(ch);
+    }
+
+    void reserve(size_t size) {
+        if (size > check.size()) {
+            size_t newSize = std::max(size, check.size() * 2);
+            base.resize(newSize, 0);
+            check.resize(newSize, FREE);
+        }
+    }
+
+    // Наименьший base, при котором свободны все ячейки base + codes[i]
+    int32_t findBase(const std::vector<int>& codes) {
+        while (firstFree < check.size() && check[firstFree] != FREE) firstFree++;
+        int32_t b = std::max<int32_t>(1, static_cast<int32_t>(firstFree) - codes[0]);
+        while (true) {
+            reserve(b + codes.back() + 1);
+            bool fits = true;
+            for (int c : codes) {
+                if (check[b + c] != FREE) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) return b;
+            b++;
+        }
+    }
+
+public:
+    DoubleArrayTrie() {
+        reserve(256);
+        check[0] = ROOT;
+    }
+
+    // Построение из отсортированного списка слов (неотсортированный сортируется)
+    void build(std::vector<std::string> words) {
+        if (!std::is_sorted(words.begin(), words.end())) {
+            std::sort(words.begin(), words.end());
+        }
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+
+        base.assign(256, 0);
+        check.assign(256, FREE);
+        check[0] = ROOT;
+        firstFree = 1;
+        counters = TrieStats();
+
+        struct Task {
+            int32_t state;
+            size_t lo, hi;  // Слова [lo, hi) проходят через состояние
+            size_t depth;
+        };
+        std::vector<Task> stack;
+        std::vector<int> codes;
+        std::vector<size_t> bounds;  // Начало группы слов для каждого кода
+        stack.push_back({ 0, 0, words.size(), 0 });
+        while (!stack.empty()) {
+            Task task = stack.back();
+            stack.pop_back();
+
+            codes.clear();
+            bounds.clear();
+            for (size_t i = task.lo; i < task.hi; i++) {
+                int c = words[i].size() == task.depth ? 0 : code(words[i][task.depth]);
+                if (codes.empty() || codes.back() != c) {
+                    codes.push_back(c);
+                    bounds.push_back(i);
+                }
+            }
+            bounds.push_back(task.hi);
+            if (codes.empty()) continue;
+
+            int32_t b = findBase(codes);
+            base[task.state] = b;
+            for (int c : codes) {
+                check[b + c] = task.state;
+            }
+
+            int children = static_cast<int>(codes.size()) - (codes[0] == 0 ? 1 : 0);
+            if (codes[0] == 0) counters.words++;
+            if (task.state != 0) {
+                if (children > 0) counters.internalNodes++;
+                if (children > 1) {
+                    counters.branchingNodes++;
+                    counters.branchingPaths += children;
+                    counters.pathBranchings++;
+                }
+            }
+            for (size_t k = 0; k < codes.size(); k++) {
+                if (codes[k] == 0) continue;
+                counters.totalNodes++;
+                stack.push_back({ b + codes[k], bounds[k], bounds[k + 1], task.depth + 1 });
+            }
+        }
+
+        // Хвост после последней занятой ячейки не нужен
+        size_t used = check.size();
+        while (used > 1 && check[used - 1] == FREE) used--;
+        base.resize(used + 257, 0);
+        check.resize(used + 257, FREE);
+        base.shrink_to_fit();
+        check.shrink_to_fit();
+        counters.memoryBytes = base.size() * sizeof(int32_t) + check.size() * sizeof(int32_t);
+    }
+
+    DoubleArrayView view() const {
+        return { base.data(), check.data(), check.size() };
+    }
+
+    bool search(const std::string& word) const {
+        return view().search(word);
+    }
+
+    bool startsWith(const std::string& prefix) const {
+        return view().startsWith(prefix);
+    }
+
+    std::vector<size_t> prefixMatches(const std::string& text) const {
+        return view().prefixMatches(text);
+    }
+
+    // Параметры дерева, посчитанные при построении
+    const TrieStats& stats() const {
+        return counters;
+    }
+
+    size_t calculateMemoryUsage() const {
+        return counters.memoryBytes;
+    }
+
+    int totalChars() const {
+        return counters.totalNodes;
+    }
+
+    int wordCount() const {
+        return counters.words;
+    }
+
+    int internalNodeCount() const {
+        return counters.internalNodes;
+    }
+
+    int branchingNodeCount() const {
+        return counters.branchingNodes;
+    }
+
+    double averageBranchingPaths() const {
+        return counters.avgBranching();
+    }
+};
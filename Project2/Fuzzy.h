@@ -0,0 +1,73 @@
+﻿#pragma once
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Нечеткий поиск: слова на расстоянии Левенштейна не больше maxEdits.
+// Дерево обходится в глубину, на каждой глубине хранится одна строка таблицы
+// расстояний между префиксом пути и искомым словом. Общие префиксы считаются
+// один раз, а поддерево отбрасывается, как только минимум строки больше maxEdits.
+
+struct FuzzyMatch {
+    std::string word;
+    int distance;
+};
+
+// forEachChild(node, visit) вызывает visit(символ, ребенок) по возрастанию символа;
+// результат упорядочен по словам
+template <class Node, class ForEachChild>
+std::vector<FuzzyMatch> fuzzyMatches(Node* root, const std::string& word, int maxEdits,
+    ForEachChild forEachChild) {
+    std::vector<FuzzyMatch> result;
+    if (!root || maxEdits < 0) return result;
+
+    const size_t width = word.size() + 1;
+    std::vector<int> rows(width);  // Строка глубины d - rows[d * width, (d + 1) * width)
+    for (size_t j = 0; j < width; j++) rows[j] = static_cast<int>(j);
+    if (root->isEndOfWord && static_cast<int>(word.size()) <= maxEdits) {
+        result.push_back({ std::string(), static_cast<int>(word.size()) });
+    }
+
+    struct Entry {
+        Node* node;
+        size_t depth;
+        char ch;
+    };
+    std::vector<Entry> stack;
+    std::vector<Entry> children;
+    std::string key;
+    auto pushChildren = [&](Node* node, size_t depth) {
+        children.clear();
+        forEachChild(node, [&](char ch, Node* child) {
+            children.push_back({ child, depth + 1, ch });
+        });
+        stack.insert(stack.end(), children.rbegin(), children.rend());  // Меньший символ - первым
+    };
+    pushChildren(root, 0);
+
+    while (!stack.empty()) {
+        Entry entry = stack.back();
+        stack.pop_back();
+        key.resize(entry.depth - 1);
+        key += entry.ch;
+
+        if (rows.size() < (entry.depth + 1) * width) rows.resize((entry.depth + 1) * width);
+        const int* above = &rows[(entry.depth - 1) * width];
+        int* row = &rows[entry.depth * width];
+        row[0] = static_cast<int>(entry.depth);
+        int best = row[0];
+        for (size_t j = 1; j < width; j++) {
+            int replace = above[j - 1] + (word[j - 1] == entry.ch ? 0 : 1);
+            row[j] = std::min({ above[j] + 1, row[j - 1] + 1, replace });
+            best = std::min(best, row[j]);
+        }
+
+        if (entry.node->isEndOfWord && row[width - 1] <= maxEdits) {
+            result.push_back({ key, row[width - 1] });
+        }
+        if (best <= maxEdits) {
+            pushChildren(entry.node, entry.depth);
+        }
+    }
+    return result;
+}
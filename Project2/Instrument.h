@@ -0,0 +1,334 @@
+﻿#pragma once
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Замеры горячих операций, включаются определением TRIE_INSTRUMENT
+// (cmake -DTRIE_INSTRUMENT=ON). Без него макросы TRIE_PROBE* пустые и код
+// операций не меняется.
+//
+// TRIE_PROBE(op)      - замер до конца блока: задержка, посещенные узлы, шаги по спискам
+// TRIE_PROBE_NODE()   - переход в следующий узел
+// TRIE_PROBE_STEP()   - шаг по списку детей
+// Вложенные замеры добавляют свои узлы и шаги к внешнему (getChild внутри search).
+
+// Гистограмма неотрицательных целых: значения до 16 точно, дальше 16 корзин
+// на каждую степень двойки, поэтому перцентиль завышается не больше чем на 1/16
+class LogHistogram {
+private:
+    static const int SUB = 16;
+    std::array<uint64_t, 64 * SUB> counts{};
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t maxValue = 0;
+
+    static size_t index(uint64_t value) {
+        if (value < SUB) return static_cast<size_t>(value);
+        int msb = static_cast<int>(std::bit_width(value)) - 1;
+        return static_cast<size_t>(msb - 3) * SUB + ((value >> (msb - 4)) & (SUB - 1));
+    }
+
+    // Наибольшее значение корзины
+    static uint64_t upperBound(size_t i) {
+        if (i < SUB) return i;
+        int shift = static_cast<int>(i / SUB) - 1;
+        uint64_t lower = (SUB + i % SUB) << shift;
+        return lower + (uint64_t(1) << shift) - 1;
+    }
+
+public:
+    void record(uint64_t value) {
+        counts[index(value)]++;
+        total++;
+        sum += value;
+        if (value > maxValue) maxValue = value;
+    }
+
+    LogHistogram& operator+=(const LogHistogram& other) {
+        for (size_t i = 0; i < counts.size(); i++) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        sum += other.sum;
+        if (other.maxValue > maxValue) maxValue = other.maxValue;
+        return *this;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t max() const { return maxValue; }
+
+    double mean() const {
+        return total ? static_cast<double>(sum) / total : 0.0;
+    }
+
+    // Значение, не меньше которого q-я доля записей (q из [0, 1])
+    uint64_t percentile(double q) const {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(std::ceil(q * total));
+        if (rank < 1) rank = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); i++) {
+            seen += counts[i];
+            if (seen >= rank) return upperBound(i) < maxValue ? upperBound(i) : maxValue;
+        }
+        return maxValue;
+    }
+};
+
+// Аппаратные счетчики процесса через perf_event_open (только Linux): инструкции
+// и промахи кэша за участок между start() и stop(). Чтение - системный вызов,
+// поэтому счетчики снимаются на целом участке, а не на каждой операции.
+class PerfCounters {
+public:
+    struct Sample {
+        uint64_t instructions = 0;
+        uint64_t cacheMisses = 0;
+    };
+
+private:
+#ifdef __linux__
+    int leader = -1;
+    int misses = -1;
+
+    static int openCounter(uint64_t config, int group) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+#endif
+
+public:
+    PerfCounters() {
+#ifdef __linux__
+        leader = openCounter(PERF_COUNT_HW_INSTRUCTIONS, -1);
+        if (leader >= 0) misses = openCounter(PERF_COUNT_HW_CACHE_MISSES, leader);
+#endif
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        if (misses >= 0) close(misses);
+        if (leader >= 0) close(leader);
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // false - нет Linux, нет прав (kernel.perf_event_paranoid) или нет счетчиков у процессора
+    bool available() const {
+#ifdef __linux__
+        return leader >= 0 && misses >= 0;
+#else
+        return false;
+#endif
+    }
+
+    void start() {
+#ifdef __linux__
+        if (!available()) return;
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    Sample stop() {
+        Sample sample;
+#ifdef __linux__
+        if (!available()) return sample;
+        ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        uint64_t values[3] = {};  // Число счетчиков, затем значения по порядку открытия
+        if (read(leader, values, sizeof(values)) == static_cast<ssize_t>(sizeof(values))) {
+            sample.instructions = values[1];
+            sample.cacheMisses = values[2];
+        }
+#endif
+        return sample;
+    }
+};
+
+#ifdef TRIE_INSTRUMENT
+
+enum class ProbeOp { Insert, Search, GetChild, Count };
+
+inline const char* probeName(ProbeOp op) {
+    static const char* const names[] = { "insert", "search", "getChild" };
+    return names[static_cast<int>(op)];
+}
+
+// Распределения по одной операции
+struct OpProbe {
+    LogHistogram latencyNs;
+    LogHistogram nodesVisited;
+    LogHistogram listSteps;
+
+    OpProbe& operator+=(const OpProbe& other) {
+        latencyNs += other.latencyNs;
+        nodesVisited += other.nodesVisited;
+        listSteps += other.listSteps;
+        return *this;
+    }
+};
+
+struct ProbeSet {
+    std::array<OpProbe, static_cast<size_t>(ProbeOp::Count)> ops;
+
+    OpProbe& operator[](ProbeOp op) { return ops[static_cast<size_t>(op)]; }
+    const OpProbe& operator[](ProbeOp op) const { return ops[static_cast<size_t>(op)]; }
+
+    ProbeSet& operator+=(const ProbeSet& other) {
+        for (size_t i = 0; i < ops.size(); i++) {
+            ops[i] += other.ops[i];
+        }
+        return *this;
+    }
+};
+
+// Замеры всех потоков: каждый поток пишет в свой ProbeSet, при выходе потока
+// его замеры переносятся в retired. snapshot() и reset() вызываются между
+// участками работы, когда замеряемые операции не выполняются.
+class ProbeRegistry {
+private:
+    std::mutex lock;
+    std::vector<ProbeSet*> live;
+    ProbeSet retired;
+
+public:
+    static ProbeRegistry& instance() {
+        static ProbeRegistry registry;
+        return registry;
+    }
+
+    void attach(ProbeSet* set) {
+        std::lock_guard<std::mutex> guard(lock);
+        live.push_back(set);
+    }
+
+    void detach(ProbeSet* set) {
+        std::lock_guard<std::mutex> guard(lock);
+        retired += *set;
+        for (size_t i = 0; i < live.size(); i++) {
+            if (live[i] == set) {
+                live[i] = live.back();
+                live.pop_back();
+                break;
+            }
+        }
+    }
+
+    ProbeSet snapshot() {
+        std::lock_guard<std::mutex> guard(lock);
+        ProbeSet result = retired;
+        for (ProbeSet* set : live) {
+            result += *set;
+        }
+        return result;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> guard(lock);
+        retired = ProbeSet();
+        for (ProbeSet* set : live) {
+            *set = ProbeSet();
+        }
+    }
+};
+
+struct ThreadProbes {
+    ProbeSet set;
+
+    ThreadProbes() { ProbeRegistry::instance().attach(&set); }
+    ~ThreadProbes() { ProbeRegistry::instance().detach(&set); }
+};
+
+inline thread_local ThreadProbes threadProbes;
+
+// Открытый замер текущего потока; внешние замеры связаны через parent
+struct ProbeFrame {
+    ProbeFrame* parent;
+    uint64_t nodes;
+    uint64_t steps;
+};
+
+inline thread_local ProbeFrame* currentProbe = nullptr;
+
+class ProbeScope {
+private:
+    ProbeOp op;
+    ProbeFrame frame;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ProbeScope(ProbeOp op) : op(op), frame{ currentProbe, 0, 0 } {
+        currentProbe = &frame;
+        start = std::chrono::steady_clock::now();
+    }
+
+    ~ProbeScope() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        OpProbe& probe = threadProbes.set[op];
+        probe.latencyNs.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        probe.nodesVisited.record(frame.nodes);
+        probe.listSteps.record(frame.steps);
+        if (frame.parent) {
+            frame.parent->nodes += frame.nodes;
+            frame.parent->steps += frame.steps;
+        }
+        currentProbe = frame.parent;
+    }
+
+    ProbeScope(const ProbeScope&) = delete;
+    ProbeScope& operator=(const ProbeScope&) = delete;
+};
+
+inline void probeNode() {
+    if (currentProbe) currentProbe->nodes++;
+}
+
+inline void probeStep() {
+    if (currentProbe) currentProbe->steps++;
+}
+
+// Строка на операцию: число вызовов, задержка p50/p99/p999 и распределения узлов и шагов
+inline void printProbes(std::ostream& out, const ProbeSet& probes) {
+    for (size_t i = 0; i < probes.ops.size(); i++) {
+        const OpProbe& probe = probes.ops[i];
+        if (probe.latencyNs.count() == 0) continue;
+        out << "  " << probeName(static_cast<ProbeOp>(i)) << ": " << probe.latencyNs.count() << " вызовов"
+            << ", нс p50/p99/p999 " << probe.latencyNs.percentile(0.5) << "/" << probe.latencyNs.percentile(0.99)
+            << "/" << probe.latencyNs.percentile(0.999) << " (макс " << probe.latencyNs.max() << ")"
+            << ", узлов среднее/p99 " << probe.nodesVisited.mean() << "/" << probe.nodesVisited.percentile(0.99)
+            << ", шагов по спискам среднее/p99 " << probe.listSteps.mean() << "/" << probe.listSteps.percentile(0.99)
+            << "\n";
+    }
+}
+
+#define TRIE_PROBE(op) ProbeScope trieProbeScope(op)
+#define TRIE_PROBE_NODE() probeNode()
+#define TRIE_PROBE_STEP() probeStep()
+
+#else
+
+#define TRIE_PROBE(op) ((void)0)
+#define TRIE_PROBE_NODE() ((void)0)
+#define TRIE_PROBE_STEP() ((void)0)
+
+#endif
@@ -0,0 +1,320 @@
+﻿#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Arena.h"
+#include "Autocomplete.h"
+#include "BasicTrie.h"
+#include "Cursor.h"
+#include "Instrument.h"
+#include "LoudsTrie.h"
+#include "Parallel.h"
+#include "Prefetch.h"
+#include "TrieStats.h"
+
+// Способ с листом
+
+class TrieNode;
+
+struct ListNode {
+    char ch;
+    TrieNode* next;
+    ListNode* nextListNode;
+
+    ListNode(char c) : ch(c), next(nullptr), nextListNode(nullptr) {}
+};
+
+class TrieNode {
+public:
+    ListNode* head;
+    bool isEndOfWord;
+    int childCount;
+    uint32_t weight;     // Вес слова для автодополнения
+    uint32_t maxWeight;  // Наибольший вес слова в поддереве
+
+    TrieNode() : head(nullptr), isEndOfWord(false), childCount(0), weight(0), maxWeight(0) {}
+
+    // Обход детей узла для обобщенных алгоритмов
+    template <class Visit>
+    void forEachChild(Visit visit) {
+        for (ListNode* current = head; current; current = current->nextListNode) {
+            visit(current->ch, current->next);
+        }
+    }
+
+    // Дети упорядочены по возрастанию символа, поэтому поиск останавливается
+    // на первом большем символе
+    TrieNode* getChild(char ch) {
+        TRIE_PROBE(ProbeOp::GetChild);
+        unsigned char key = static_cast<unsigned char>(ch);
+        for (ListNode* current = head; current; current = current->nextListNode) {
+            TRIE_PROBE_STEP();
+            unsigned char label = static_cast<unsigned char>(current->ch);
+            if (label == key) {
+                return current->next;
+            }
+            if (label > key) {
+                break;
+            }
+        }
+        return nullptr;
+    }
+
+    // Добавление ребенка с сохранением порядка; возвращает ребенка с символом ch
+    template <class Alloc>
+    TrieNode* addChild(char ch, Alloc& alloc) {
+        unsigned char key = static_cast<unsigned char>(ch);
+        ListNode** link = &head;
+        while (*link && static_cast<unsigned char>((*link)->ch) < key) {
+            link = &(*link)->nextListNode;
+        }
+        if (*link && (*link)->ch == ch) {
+            return (*link)->next;
+        }
+        ListNode* added = alloc.template create<ListNode>(ch);
+        added->next = alloc.template create<TrieNode>();
+        added->nextListNode = *link;
+        *link = added;
+        childCount++;
+        return added->next;
+    }
+
+    // Удаление элемента списка с символом ch; ребенок, на который он указывал, не освобождается
+    template <class Alloc>
+    void removeChild(char ch, Alloc& alloc) {
+        for (ListNode** link = &head; *link; link = &(*link)->nextListNode) {
+            if ((*link)->ch == ch) {
+                ListNode* removed = *link;
+                *link = removed->nextListNode;
+                alloc.destroy(removed);
+                childCount--;
+                return;
+            }
+        }
+    }
+};
+
+// Упорядоченный обход слов для TrieCursor: позиция - элемент списка детей
+struct ListCursorTraits {
+    using Node = TrieNode;
+    using Pos = ListNode*;
+
+    static ListNode* first(TrieNode* node) { return node->head; }
+    static ListNode* lowerBound(TrieNode* node, char ch) {
+        ListNode* current = node->head;
+        while (current && static_cast<unsigned char>(current->ch) < static_cast<unsigned char>(ch)) {
+            current = current->nextListNode;
+        }
+        return current;
+    }
+    static bool valid(TrieNode*, ListNode* pos) { return pos != nullptr; }
+    static ListNode* next(TrieNode*, ListNode* pos) { return pos->nextListNode; }
+    static char label(TrieNode*, ListNode* pos) { return pos->ch; }
+    static TrieNode* child(TrieNode*, ListNode* pos) { return pos->next; }
+    static bool isEnd(TrieNode* node) { return node->isEndOfWord; }
+};
+
+using ListCursor = TrieCursor<ListCursorTraits>;
+
+// Раскладка узла со списком детей для BasicTrie
+struct ListNodePolicy {
+    using Node = TrieNode;
+    using CursorTraits = ListCursorTraits;
+    static constexpr size_t CHILD_BYTES = sizeof(TrieNode) + sizeof(ListNode);
+
+    static bool accepts(char) { return true; }
+    static TrieNode* findChild(TrieNode* node, char ch) { return node->getChild(ch); }
+
+    template <class Alloc>
+    static TrieNode* addChild(TrieNode* node, char ch, Alloc& alloc) { return node->addChild(ch, alloc); }
+
+    template <class Alloc>
+    static void removeChild(TrieNode* node, char ch, Alloc& alloc) { node->removeChild(ch, alloc); }
+
+    template <class Visit>
+    static void forEachChild(TrieNode* node, Visit visit) { node->forEachChild(visit); }
+};
+
+using ListTrie = BasicTrie<ListNodePolicy>;
+
+// Дерево со списками детей: общий движок и операции, которые есть только у этого способа
+class Trie : public ListTrie {
+public:
+    using ListTrie::ListTrie;
+    using ListTrie::insert;
+
+    void printTree() {
+        printNode(root, "", true);
+    }
+
+    void printNode(TrieNode* node, const std::string& prefix, bool isLast) {
+        if (!node) return;
+
+        if (node == root) {
+            std::cout << prefix << (isLast ? "`-- " : "|-- ") << "[root]\n";
+        }
+
+        ListNode* current = node->head;
+        while (current) {
+            std::string newPrefix = prefix + (isLast ? "    " : "|   ");
+
+            std::cout << newPrefix;
+            std::cout << (current->nextListNode ? "|-- " : "`-- ");
+            std::cout << current->ch;
+            if (current->next->isEndOfWord) {
+                std::cout << " (end)";
+            }
+            std::cout << "\n";
+
+            printNode(current->next, newPrefix, !current->nextListNode);
+
+            current = current->nextListNode;
+        }
+    }
+    // Вставка слова с весом для автодополнения (повторная вставка меняет вес)
+    bool insert(const std::string& word, uint32_t weight) {
+        if (!insertFrom(root, word, 0, true, counters, *alloc)) return false;
+        std::vector<TrieNode*> path;
+        path.push_back(root);
+        for (char ch : word) {
+            path.push_back(path.back()->getChild(ch));
+        }
+        path.back()->weight = weight;
+        updateMaxWeights(path, [](TrieNode* node, auto visit) { node->forEachChild(visit); });
+        return true;
+    }
+
+    // k слов с наибольшим весом среди начинающихся с prefix
+    std::vector<Completion> complete(const std::string& prefix, size_t k) {
+        TrieNode* current = root;
+        for (char ch : prefix) {
+            current = current->getChild(ch);
+            if (!current) {
+                return {};
+            }
+        }
+        return topCompletions(current, prefix, k, [](TrieNode* node, auto visit) { node->forEachChild(visit); });
+    }
+
+    // Параллельное построение: поддерево каждого первого символа строит отдельный
+    // поток в своей арене, затем поддеревья подвешиваются к корню
+    void buildParallel(const std::vector<std::string>& words, unsigned threads = defaultThreadCount()) {
+        clear();
+        std::vector<std::vector<const std::string*>> buckets = partitionByFirstChar(words);
+
+        std::vector<std::unique_ptr<Arena>> arenas;
+        for (unsigned i = 0; i < std::max(threads, 1u); i++) {
+            arenas.emplace_back(new Arena());
+        }
+        std::vector<TrieNode*> subtrees(buckets.size(), nullptr);
+        std::vector<TrieStats> partial(buckets.size());
+        parallelFor(buckets.size(), threads, [&](unsigned worker, size_t index) {
+            if (buckets[index].empty()) return;
+            Arena& local = *arenas[worker];
+            TrieNode* subtree = local.create<TrieNode>();
+            for (const std::string* word : buckets[index]) {
+                insertFrom(subtree, *word, 1, false, partial[index], local);
+            }
+            subtrees[index] = subtree;
+        });
+
+        ListNode** tail = &root->head;
+        for (size_t i = 0; i < subtrees.size(); i++) {
+            if (!subtrees[i]) continue;
+            counters.onChildAdded(root->childCount, true, ListNodePolicy::CHILD_BYTES);
+            root->childCount++;
+            *tail = alloc->create<ListNode>(static_cast<char>(i));
+            (*tail)->next = subtrees[i];
+            tail = &(*tail)->nextListNode;
+            counters += partial[i];
+        }
+        for (std::unique_ptr<Arena>& local : arenas) {
+            alloc->absorb(*local);
+        }
+        for (const std::string& word : words) {
+            if (word.empty() && !root->isEndOfWord) {
+                root->isEndOfWord = true;
+                counters.words++;
+            }
+        }
+    }
+
+    // Пакетный поиск: BATCH_GROUP поисков идут вперемешку, каждый шаг разыменовывает
+    // один узел (TrieNode или ListNode) и выдает prefetch для следующего
+    void searchBatch(std::span<const std::string> words, std::span<bool> results) {
+        struct Lookup {
+            size_t word;          // Номер слова в words
+            size_t pos;           // Номер следующего символа
+            TrieNode* node;       // Текущий узел, если list == nullptr
+            ListNode* list;       // Текущий элемент списка детей node
+        };
+        Lookup group[BATCH_GROUP];
+        int active = 0;
+        size_t nextWord = 0;
+        for (; active < BATCH_GROUP && nextWord < words.size(); active++, nextWord++) {
+            group[active] = { nextWord, 0, root, nullptr };
+        }
+
+        while (active > 0) {
+            for (int g = 0; g < active;) {
+                Lookup& lookup = group[g];
+                const std::string& word = words[lookup.word];
+                bool done = false;
+                if (!lookup.list) {
+                    if (lookup.pos == word.size()) {
+                        results[lookup.word] = lookup.node->isEndOfWord;
+                        done = true;
+                    }
+                    else if (!lookup.node->head) {
+                        results[lookup.word] = false;
+                        done = true;
+                    }
+                    else {
+                        lookup.list = lookup.node->head;
+                        prefetch(lookup.list);
+                    }
+                }
+                else if (lookup.list->ch == word[lookup.pos]) {
+                    lookup.node = lookup.list->next;
+                    lookup.list = nullptr;
+                    lookup.pos++;
+                    prefetch(lookup.node);
+                }
+                else if (!lookup.list->nextListNode) {
+                    results[lookup.word] = false;
+                    done = true;
+                }
+                else {
+                    lookup.list = lookup.list->nextListNode;
+                    prefetch(lookup.list);
+                }
+
+                if (!done) {
+                    g++;
+                }
+                else if (nextWord < words.size()) {
+                    group[g] = { nextWord++, 0, root, nullptr };
+                }
+                else {
+                    group[g] = group[--active];
+                }
+            }
+        }
+    }
+
+    // Заморозка дерева в неизменяемое сжатое представление LOUDS
+    LoudsTrie freeze() {
+        return LoudsTrie::build(root,
+            [](TrieNode* node, std::vector<std::pair<char, TrieNode*>>& out) {
+                for (ListNode* current = node->head; current; current = current->nextListNode) {
+                    out.push_back({ current->ch, current->next });
+                }
+            },
+            [](TrieNode* node) { return node->isEndOfWord; });
+    }
+};
@@ -0,0 +1,239 @@
+﻿#pragma once
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "TrieStats.h"
+
+// Битовый вектор с поддержкой rank/select
+class BitVector {
+private:
+    static const size_t SUPER_BITS = 512;  // Размер суперблока для rank
+
+    std::vector<uint64_t> words;
+    std::vector<uint32_t> superRanks;  // Единицы до начала каждого суперблока
+    size_t bitCount = 0;
+
+    static size_t popcount(uint64_t x) {
+        return std::bitset<64>(x).count();
+    }
+
+public:
+    void push(bool bit) {
+        if (bitCount % 64 == 0) words.push_back(0);
+        if (bit) words.back() |= uint64_t(1) << (bitCount % 64);
+        bitCount++;
+    }
+
+    bool get(size_t i) const {
+        return (words[i / 64] >> (i % 64)) & 1;
+    }
+
+    size_t size() const {
+        return bitCount;
+    }
+
+    // Построение индекса для rank/select, вызывается после заполнения
+    void buildIndex() {
+        superRanks.clear();
+        uint32_t ones = 0;
+        for (size_t w = 0; w < words.size(); w++) {
+            if (w % (SUPER_BITS / 64) == 0) superRanks.push_back(ones);
+            ones += static_cast<uint32_t>(popcount(words[w]));
+        }
+        superRanks.push_back(ones);
+    }
+
+    // Количество единиц в [0, i)
+    size_t rank1(size_t i) const {
+        size_t super = i / SUPER_BITS;
+        size_t result = superRanks[super];
+        for (size_t w = super * (SUPER_BITS / 64); w < i / 64; w++) {
+            result += popcount(words[w]);
+        }
+        if (i % 64) result += popcount(words[i / 64] & ((uint64_t(1) << (i % 64)) - 1));
+        return result;
+    }
+
+    // Позиция k-го нуля (k >= 1)
+    size_t select0(size_t k) const {
+        // Последний суперблок, до которого меньше k нулей
+        size_t lo = 0, hi = superRanks.size() - 1;
+        while (hi - lo > 1) {
+            size_t mid = (lo + hi) / 2;
+            if (mid * SUPER_BITS - superRanks[mid] < k) lo = mid;
+            else hi = mid;
+        }
+        size_t w = lo * (SUPER_BITS / 64);
+        k -= lo * SUPER_BITS - superRanks[lo];
+        while (true) {
+            size_t zeros = 64 - popcount(words[w]);
+            if (zeros >= k) break;
+            k -= zeros;
+            w++;
+        }
+        uint64_t inverted = ~words[w];
+        for (size_t bit = 0;; bit++) {
+            if ((inverted >> bit) & 1) {
+                if (--k == 0) return w * 64 + bit;
+            }
+        }
+    }
+
+    size_t bytes() const {
+        return words.size() * sizeof(uint64_t) + superRanks.size() * sizeof(uint32_t);
+    }
+};
+
+// Неизменяемое сжатое дерево в кодировке LOUDS (Level-Order Unary Degree Sequence).
+// Узлы нумеруются в порядке обхода в ширину, корень - 0. Для каждого узла
+// записываются deg единиц и ноль, перед всем - "10" для фиктивного корня.
+// Дети узла v начинаются после (v + 1)-го нуля, номер ребенка - rank1 его бита.
+class LoudsTrie {
+private:
+    BitVector louds;
+    BitVector endOfWord;       // Бит конца слова по номеру узла
+    std::vector<char> labels;  // Символ ребра, ведущего в узел
+    TrieStats counters;
+
+    // Первый ребенок и число детей узла v
+    std::pair<size_t, size_t> children(size_t v) const {
+        size_t start = louds.select0(v + 1) + 1;
+        size_t end = start;
+        while (louds.get(end)) end++;
+        return { louds.rank1(start), end - start };
+    }
+
+    // Ребенок узла v по символу или 0, если его нет (корень ребенком быть не может)
+    size_t child(size_t v, char ch) const {
+        std::pair<size_t, size_t> range = children(v);
+        size_t lo = range.first, hi = range.first + range.second;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (static_cast<unsigned char>(labels[mid]) < static_cast<unsigned char>(ch)) lo = mid + 1;
+            else hi = mid;
+        }
+        return (lo < range.first + range.second && labels[lo] == ch) ? lo : 0;
+    }
+
+    // Узел, в который ведет префикс, или -1
+    long long descend(const std::string& prefix) const {
+        size_t v = 0;
+        for (char ch : prefix) {
+            v = child(v, ch);
+            if (!v) return -1;
+        }
+        return static_cast<long long>(v);
+    }
+
+public:
+    // Заморозка дерева. childrenOf(node, out) заполняет out парами (символ, ребенок),
+    // isEnd(node) возвращает признак конца слова
+    template <class Node, class ChildrenOf, class IsEnd>
+    static LoudsTrie build(Node* root, ChildrenOf childrenOf, IsEnd isEnd) {
+        LoudsTrie trie;
+        trie.louds.push(true);
+        trie.louds.push(false);
+
+        std::vector<Node*> level;  // Очередь обхода в ширину
+        std::vector<std::pair<char, Node*>> kids;
+        level.push_back(root);
+        trie.labels.push_back(0);
+        for (size_t head = 0; head < level.size(); head++) {
+            Node* node = level[head];
+            kids.clear();
+            childrenOf(node, kids);
+            std::sort(kids.begin(), kids.end(),
+                [](const std::pair<char, Node*>& a, const std::pair<char, Node*>& b) {
+                    return static_cast<unsigned char>(a.first) < static_cast<unsigned char>(b.first);
+                });
+            for (const std::pair<char, Node*>& kid : kids) {
+                trie.louds.push(true);
+                trie.labels.push_back(kid.first);
+                level.push_back(kid.second);
+            }
+            trie.louds.push(false);
+            trie.endOfWord.push(isEnd(node));
+
+            int deg = static_cast<int>(kids.size());
+            if (isEnd(node)) trie.counters.words++;
+            if (head == 0) continue;
+            trie.counters.totalNodes++;
+            if (deg > 0) trie.counters.internalNodes++;
+            if (deg > 1) {
+                trie.counters.branchingNodes++;
+                trie.counters.branchingPaths += deg;
+                trie.counters.pathBranchings++;
+            }
+        }
+        trie.louds.buildIndex();
+        trie.endOfWord.buildIndex();
+        trie.counters.memoryBytes = trie.louds.bytes() + trie.endOfWord.bytes() + trie.labels.size();
+        return trie;
+    }
+
+    bool search(const std::string& word) const {
+        long long v = descend(word);
+        return v >= 0 && endOfWord.get(static_cast<size_t>(v));
+    }
+
+    // Есть ли слова с данным префиксом
+    bool startsWith(const std::string& prefix) const {
+        return descend(prefix) >= 0;
+    }
+
+    // Слова с данным префиксом в лексикографическом порядке (не более limit)
+    std::vector<std::string> wordsWithPrefix(const std::string& prefix, size_t limit = SIZE_MAX) const {
+        std::vector<std::string> result;
+        long long start = descend(prefix);
+        if (start < 0) return result;
+
+        std::string word = prefix;
+        std::vector<std::pair<size_t, size_t>> stack;  // (узел, длина слова до него)
+        stack.push_back({ static_cast<size_t>(start), prefix.size() });
+        while (!stack.empty() && result.size() < limit) {
+            size_t v = stack.back().first;
+            word.resize(stack.back().second);
+            stack.pop_back();
+            if (v != static_cast<size_t>(start)) word += labels[v];
+            if (endOfWord.get(v)) result.push_back(word);
+
+            std::pair<size_t, size_t> range = children(v);
+            for (size_t i = range.second; i > 0; i--) {
+                stack.push_back({ range.first + i - 1, word.size() });
+            }
+        }
+        return result;
+    }
+
+    // Параметры дерева, посчитанные при заморозке
+    const TrieStats& stats() const {
+        return counters;
+    }
+
+    size_t calculateMemoryUsage() const {
+        return counters.memoryBytes;
+    }
+
+    int totalChars() const {
+        return counters.totalNodes;
+    }
+
+    int wordCount() const {
+        return counters.words;
+    }
+
+    int internalNodeCount() const {
+        return counters.internalNodes;
+    }
+
+    int branchingNodeCount() const {
+        return counters.branchingNodes;
+    }
+
+    double averageBranchingPaths() const {
+        return counters.avgBranching();
+    }
+};
@@ -0,0 +1,197 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "DoubleArrayTrie.h"
+#include "TrieStats.h"
+
+// Файловый формат двойного массива: заголовок и массивы base/check без указателей,
+// все ссылки - смещения от начала файла. Файл отображается в память (mmap)
+// и используется для поиска напрямую, без разбора и копирования.
+
+const char TRIE_FILE_MAGIC[4] = { 'D', 'A', 'T', 'R' };
+const uint32_t TRIE_FILE_VERSION = 1;
+const uint32_t TRIE_FILE_BYTE_ORDER = 0x01020304;  // Проверка порядка байт
+
+struct TrieFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t byteOrder;
+    uint64_t cellCount;    // Длина массивов base и check
+    uint64_t baseOffset;   // Смещения массивов от начала файла
+    uint64_t checkOffset;
+    int32_t totalNodes;    // Параметры дерева
+    int32_t words;
+    int32_t internalNodes;
+    int32_t branchingNodes;
+    int32_t branchingPaths;
+    int32_t pathBranchings;
+};
+
+// Запись двойного массива в файл; false при ошибке ввода-вывода
+inline bool writeTrieFile(const DoubleArrayTrie& trie, const std::string& path) {
+    DoubleArrayView view = trie.view();
+    const TrieStats& stats = trie.stats();
+
+    TrieFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TRIE_FILE_MAGIC, sizeof(header.magic));
+    header.version = TRIE_FILE_VERSION;
+    header.headerSize = sizeof(TrieFileHeader);
+    header.byteOrder = TRIE_FILE_BYTE_ORDER;
+    header.cellCount = view.size;
+    header.baseOffset = sizeof(TrieFileHeader);
+    header.checkOffset = header.baseOffset + view.size * sizeof(int32_t);
+    header.totalNodes = stats.totalNodes;
+    header.words = stats.words;
+    header.internalNodes = stats.internalNodes;
+    header.branchingNodes = stats.branchingNodes;
+    header.branchingPaths = stats.branchingPaths;
+    header.pathBranchings = stats.pathBranchings;
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+        std::fwrite(view.base, sizeof(int32_t), view.size, file) == view.size &&
+        std::fwrite(view.check, sizeof(int32_t), view.size, file) == view.size;
+    return std::fclose(file) == 0 && ok;
+}
+
+// Дерево, отображенное из файла. Несколько процессов, открывших один файл,
+// делят одни и те же страницы кэша.
+class MappedTrie {
+private:
+    const char* data = nullptr;
+    size_t length = 0;
+    DoubleArrayView arrays = { nullptr, nullptr, 0 };
+    TrieStats counters;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    bool mapFile(const std::string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) return false;
+        length = static_cast<size_t>(size.QuadPart);
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return false;
+        data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        return data != nullptr;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        length = static_cast<size_t>(st.st_size);
+        void* p = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);  // Отображение остается действительным после закрытия
+        if (p == MAP_FAILED) return false;
+        data = static_cast<const char*>(p);
+        return true;
+#endif
+    }
+
+public:
+    MappedTrie() = default;
+    MappedTrie(const MappedTrie&) = delete;
+    MappedTrie& operator=(const MappedTrie&) = delete;
+
+    ~MappedTrie() {
+        close();
+    }
+
+    // Отображение файла и проверка заголовка; false, если файл не подходит
+    bool open(const std::string& path) {
+        close();
+        if (!mapFile(path) || length < sizeof(TrieFileHeader)) {
+            close();
+            return false;
+        }
+        const TrieFileHeader* header = reinterpret_cast<const TrieFileHeader*>(data);
+        // Поля заголовка не складываются: сумма смещений из испорченного файла может переполниться
+        uint64_t arrayBytes = header->cellCount * sizeof(int32_t);
+        if (std::memcmp(header->magic, TRIE_FILE_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != TRIE_FILE_VERSION ||
+            header->headerSize != sizeof(TrieFileHeader) ||
+            header->byteOrder != TRIE_FILE_BYTE_ORDER ||
+            header->cellCount == 0 || header->cellCount > length ||
+            header->baseOffset % alignof(int32_t) != 0 || header->checkOffset % alignof(int32_t) != 0 ||
+            header->baseOffset > length || arrayBytes > length - header->baseOffset ||
+            header->checkOffset > length || arrayBytes > length - header->checkOffset) {
+            close();
+            return false;
+        }
+
+        arrays.base = reinterpret_cast<const int32_t*>(data + header->baseOffset);
+        arrays.check = reinterpret_cast<const int32_t*>(data + header->checkOffset);
+        arrays.size = static_cast<size_t>(header->cellCount);
+        counters = TrieStats();
+        counters.totalNodes = header->totalNodes;
+        counters.words = header->words;
+        counters.internalNodes = header->internalNodes;
+        counters.branchingNodes = header->branchingNodes;
+        counters.branchingPaths = header->branchingPaths;
+        counters.pathBranchings = header->pathBranchings;
+        counters.memoryBytes = length;
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (data) munmap(const_cast<char*>(data), length);
+#endif
+        data = nullptr;
+        length = 0;
+        arrays = { nullptr, nullptr, 0 };
+        counters = TrieStats();
+    }
+
+    bool isOpen() const {
+        return data != nullptr;
+    }
+
+    bool search(const std::string& word) const {
+        return isOpen() && arrays.search(word);
+    }
+
+    bool startsWith(const std::string& prefix) const {
+        return isOpen() && arrays.startsWith(prefix);
+    }
+
+    std::vector<size_t> prefixMatches(const std::string& text) const {
+        return isOpen() ? arrays.prefixMatches(text) : std::vector<size_t>();
+    }
+
+    // Параметры дерева из заголовка; память - размер отображенного файла
+    const TrieStats& stats() const {
+        return counters;
+    }
+};
@@ -0,0 +1,149 @@
+﻿#pragma once
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Число потоков по умолчанию
+inline unsigned defaultThreadCount() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+// Выполнение task(worker, i) для i из [0, count) на threads потоках.
+// Индексы раздаются по одному через атомарный счетчик, worker - номер потока.
+template <class Task>
+void parallelFor(size_t count, unsigned threads, Task task) {
+    if (threads < 1) threads = 1;
+    if (threads > count) threads = count ? static_cast<unsigned>(count) : 1;
+    std::atomic<size_t> next(0);
+    auto run = [&](unsigned worker) {
+        for (size_t i = next++; i < count; i = next++) {
+            task(worker, i);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned worker = 1; worker < threads; worker++) {
+        pool.emplace_back(run, worker);
+    }
+    run(0);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
+// Узлов, которые поток обходит сам, прежде чем отдать часть своего стека другим
+const size_t TREE_TASK_CUTOFF = 4096;
+
+// Параллельный обход дерева с перехватом работы. Каждый поток обходит свое поддерево
+// в глубину с явным стеком и копит частичный результат; раз в cutoff узлов, если его
+// очередь пуста, он выкладывает туда самый нижний узел стека - самое большое из
+// необойденных поддеревьев. Свободные потоки забирают задачи из начала чужих очередей.
+// Поддеревья меньше cutoff не делятся, при threads == 1 потоки не создаются.
+//
+// forEachChild(node, visit) - visit(символ, ребенок);
+// visit(node, depth, children, partial) - учет узла в частичном результате потока.
+// Result складывается через +=, частичные результаты суммируются по порядку потоков.
+template <class Result, class Node, class ForEachChild, class Visit>
+Result parallelTreeReduce(Node* root, ForEachChild forEachChild, Visit visit,
+    unsigned threads = defaultThreadCount(), size_t cutoff = TREE_TASK_CUTOFF) {
+    using Task = std::pair<Node*, size_t>;  // Узел и его глубина
+    if (threads < 1) threads = 1;
+    if (cutoff < 1) cutoff = 1;
+
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+    std::vector<Queue> queues(threads);
+    std::vector<Result> partials(threads);
+    std::atomic<size_t> pending(1);  // Задачи в очередях и в работе
+    queues[0].tasks.push_back({ root, 0 });
+
+    auto take = [&](unsigned worker, Task& task) {
+        for (unsigned k = 0; k < threads; k++) {
+            Queue& queue = queues[(worker + k) % threads];
+            std::lock_guard<std::mutex> guard(queue.lock);
+            if (queue.tasks.empty()) continue;
+            if (k == 0) {
+                task = queue.tasks.back();  // Своя очередь - с конца
+                queue.tasks.pop_back();
+            }
+            else {
+                task = queue.tasks.front();  // Чужая - с начала, там поддеревья крупнее
+                queue.tasks.pop_front();
+            }
+            return true;
+        }
+        return false;
+    };
+
+    auto run = [&](unsigned worker) {
+        Result& partial = partials[worker];
+        std::vector<Task> stack;
+        size_t bottom = 0;  // stack[0, bottom) уже отданы в очередь
+        Task task;
+        while (pending.load() > 0) {
+            if (!take(worker, task)) {
+                std::this_thread::yield();
+                continue;
+            }
+            stack.clear();
+            bottom = 0;
+            stack.push_back(task);
+            size_t sinceShare = 0;
+            while (stack.size() > bottom) {
+                Task top = stack.back();
+                stack.pop_back();
+                size_t children = 0;
+                forEachChild(top.first, [&](char, Node* child) {
+                    children++;
+                    stack.push_back({ child, top.second + 1 });
+                });
+                visit(top.first, top.second, children, partial);
+
+                if (threads > 1 && ++sinceShare >= cutoff && stack.size() - bottom > 1) {
+                    sinceShare = 0;
+                    Queue& own = queues[worker];
+                    std::lock_guard<std::mutex> guard(own.lock);
+                    if (own.tasks.empty()) {
+                        pending++;
+                        own.tasks.push_back(stack[bottom++]);
+                    }
+                }
+            }
+            pending--;
+        }
+    };
+
+    if (threads == 1) {
+        run(0);
+        return std::move(partials[0]);
+    }
+    std::vector<std::thread> pool;
+    for (unsigned worker = 1; worker < threads; worker++) {
+        pool.emplace_back(run, worker);
+    }
+    run(0);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    Result result = std::move(partials[0]);
+    for (unsigned worker = 1; worker < threads; worker++) {
+        result += partials[worker];
+    }
+    return result;
+}
+
+// Разбиение слов по первому байту; пустые слова в разбиение не попадают
+inline std::vector<std::vector<const std::string*>> partitionByFirstChar(const std::vector<std::string>& words) {
+    std::vector<std::vector<const std::string*>> buckets(256);
+    for (const std::string& word : words) {
+        if (!word.empty()) buckets[static_cast<unsigned char>(word[0])].push_back(&word);
+    }
+    return buckets;
+}
@@ -0,0 +1,369 @@
+﻿#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Cursor.h"
+#include "Parallel.h"
+#include "TrieStats.h"
+
+// Постоянное (persistent) дерево: версии разделяют общие узлы. Изменение копирует
+// только путь от корня до измененного узла, остальные узлы новая версия берет
+// из старой. Читатели работают со снимком - неизменяемой версией, которую писатель
+// уже никогда не трогает, поэтому чтение идет без блокировок.
+//
+// Узел живет, пока на него ссылаются родители или снимки (счетчик ссылок):
+// когда отпускается последний снимок старой версии, освобождаются узлы,
+// которых нет в других версиях.
+
+// Узел с детьми в том же блоке памяти: childCount указателей, затем childCount символов
+struct alignas(alignof(void*)) PersistentNode {
+    std::atomic<uint32_t> refs;  // Родители во всех версиях и держатели корня
+    uint32_t childCount;
+    bool isEndOfWord;
+
+    PersistentNode** children() { return reinterpret_cast<PersistentNode**>(this + 1); }
+    char* labels() { return reinterpret_cast<char*>(children() + childCount); }
+
+    static size_t bytes(uint32_t childCount) {
+        return sizeof(PersistentNode) + childCount * (sizeof(PersistentNode*) + 1);
+    }
+
+    // Позиция ребенка с символом ch или места для него; дети по возрастанию символа
+    uint32_t lowerBound(char ch) {
+        const char* begin = labels();
+        return static_cast<uint32_t>(std::lower_bound(begin, begin + childCount, ch,
+            [](char a, char b) { return static_cast<unsigned char>(a) < static_cast<unsigned char>(b); }) - begin);
+    }
+
+    PersistentNode* getChild(char ch) {
+        uint32_t pos = lowerBound(ch);
+        return pos < childCount && labels()[pos] == ch ? children()[pos] : nullptr;
+    }
+};
+
+inline std::atomic<size_t> persistentNodeCount(0);  // Живые узлы всех версий
+
+struct PersistentCursorTraits {
+    using Node = PersistentNode;
+    using Pos = uint32_t;
+
+    static uint32_t first(PersistentNode*) { return 0; }
+    static uint32_t lowerBound(PersistentNode* node, char ch) { return node->lowerBound(ch); }
+    static bool valid(PersistentNode* node, uint32_t pos) { return pos < node->childCount; }
+    static uint32_t next(PersistentNode*, uint32_t pos) { return pos + 1; }
+    static char label(PersistentNode* node, uint32_t pos) { return node->labels()[pos]; }
+    static PersistentNode* child(PersistentNode* node, uint32_t pos) { return node->children()[pos]; }
+    static bool isEnd(PersistentNode* node) { return node->isEndOfWord; }
+};
+
+using PersistentCursor = TrieCursor<PersistentCursorTraits>;
+
+class PersistentTrie {
+private:
+    using Node = PersistentNode;
+
+    static Node* allocate(uint32_t childCount, bool isEndOfWord) {
+        Node* node = static_cast<Node*>(::operator new(Node::bytes(childCount)));
+        new (&node->refs) std::atomic<uint32_t>(1);
+        node->childCount = childCount;
+        node->isEndOfWord = isEndOfWord;
+        persistentNodeCount++;
+        return node;
+    }
+
+    // Освобождение памяти узла без учета детей (дети перенесены в другой узел)
+    static void discard(Node* node) {
+        node->refs.~atomic();
+        ::operator delete(node);
+        persistentNodeCount--;
+    }
+
+    // Снятие одной ссылки; узлы, на которые больше никто не ссылается, освобождаются
+    static void release(Node* node) {
+        std::vector<Node*> stack;
+        stack.push_back(node);
+        while (!stack.empty()) {
+            Node* current = stack.back();
+            stack.pop_back();
+            if (current->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) continue;
+            for (uint32_t i = 0; i < current->childCount; i++) {
+                stack.push_back(current->children()[i]);
+            }
+            discard(current);
+        }
+    }
+
+    static void retain(Node* node) {
+        node->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Изменение одного узла пути
+    struct Edit {
+        enum Kind { SET_END, REPLACE, ADD, REMOVE } kind;
+        uint32_t pos;     // Позиция ребенка
+        char label;       // Для ADD
+        Node* child;      // Для REPLACE и ADD
+        bool end;         // Для SET_END
+        bool oldFreed;    // Для REPLACE: прежний ребенок уже освобожден при переносе
+    };
+
+    // Узел после правки. Узел, принадлежащий только рабочей версии (exclusive),
+    // меняется на месте или переносится в новый блок; общий - копируется,
+    // и копия берет ссылки на всех оставшихся детей. freed - прежний блок освобожден.
+    static Node* apply(Node* node, bool exclusive, const Edit& edit, bool& freed) {
+        freed = false;
+        uint32_t count = node->childCount;
+        if (exclusive && edit.kind == Edit::SET_END) {
+            node->isEndOfWord = edit.end;
+            return node;
+        }
+        if (exclusive && edit.kind == Edit::REPLACE) {
+            if (!edit.oldFreed) release(node->children()[edit.pos]);
+            node->children()[edit.pos] = edit.child;
+            return node;
+        }
+
+        uint32_t newCount = count + (edit.kind == Edit::ADD) - (edit.kind == Edit::REMOVE);
+        Node* copy = allocate(newCount, edit.kind == Edit::SET_END ? edit.end : node->isEndOfWord);
+        uint32_t to = 0;
+        for (uint32_t from = 0; from <= count; from++) {
+            if (edit.kind == Edit::ADD && from == edit.pos) {
+                copy->children()[to] = edit.child;
+                copy->labels()[to++] = edit.label;
+            }
+            if (from == count) break;
+            if (edit.kind == Edit::REMOVE && from == edit.pos) continue;
+            Node* child = (edit.kind == Edit::REPLACE && from == edit.pos) ? edit.child : node->children()[from];
+            if (!exclusive && child != edit.child) retain(child);
+            copy->children()[to] = child;
+            copy->labels()[to++] = node->labels()[from];
+        }
+        if (exclusive) {
+            if (edit.kind == Edit::REMOVE) release(node->children()[edit.pos]);
+            discard(node);
+            freed = true;
+        }
+        return copy;
+    }
+
+    // Правка узла path[depth] и замена ссылок на него вверх по пути до рабочего корня
+    void commitPath(const std::vector<Node*>& path, const std::string& word, size_t depth, Edit edit) {
+        std::vector<char> exclusive(path.size());
+        bool unique = true;
+        for (size_t d = 0; d < path.size(); d++) {
+            unique = unique && path[d]->refs.load(std::memory_order_acquire) == 1;
+            exclusive[d] = unique;
+        }
+        for (size_t d = depth + 1;; d--) {
+            Node* node = path[d - 1];
+            bool freed;
+            Node* result = apply(node, exclusive[d - 1], edit, freed);
+            if (result == node) return;  // Изменен на месте, выше ничего не меняется
+            if (d == 1) {
+                if (!freed) release(working);
+                working = result;
+                return;
+            }
+            Node* parent = path[d - 2];
+            edit = { Edit::REPLACE, parent->lowerBound(word[d - 2]), 0, result, false, freed };
+        }
+    }
+
+    Node* working;    // Версия писателя
+    Node* published;  // Последняя опубликованная версия
+    size_t workingWords = 0;
+    size_t publishedWords = 0;
+    mutable std::mutex publishLock;  // Только на время взятия или смены опубликованного корня
+
+public:
+    // Неизменяемая версия дерева. Копирование и хранение - O(1), версия живет,
+    // пока жив хотя бы один снимок
+    class Snapshot {
+    private:
+        Node* root;
+        size_t words;
+
+        friend class PersistentTrie;
+        Snapshot(Node* root, size_t words) : root(root), words(words) {}
+
+    public:
+        Snapshot(const Snapshot& other) : root(other.root), words(other.words) {
+            retain(root);
+        }
+
+        Snapshot& operator=(const Snapshot& other) {
+            if (this != &other) {
+                retain(other.root);
+                release(root);
+                root = other.root;
+                words = other.words;
+            }
+            return *this;
+        }
+
+        ~Snapshot() {
+            release(root);
+        }
+
+        bool search(const std::string& word) const {
+            Node* current = root;
+            for (char ch : word) {
+                current = current->getChild(ch);
+                if (!current) return false;
+            }
+            return current->isEndOfWord;
+        }
+
+        size_t wordCount() const {
+            return words;
+        }
+
+        // Слова >= from по порядку
+        PersistentCursor cursor(const std::string& from = std::string()) const {
+            return PersistentCursor(root, from);
+        }
+
+        // Слова из [from, to) по порядку
+        PersistentCursor cursor(const std::string& from, const std::string& to) const {
+            return PersistentCursor(root, from, to);
+        }
+
+        // Параметры версии; память - узлы версии, включая общие с другими версиями
+        TrieStats recount(unsigned threads = 1) const {
+            return parallelTreeReduce<TrieStats>(root,
+                [](Node* node, auto visit) {
+                    for (uint32_t i = 0; i < node->childCount; i++) {
+                        visit(node->labels()[i], node->children()[i]);
+                    }
+                },
+                [](Node* node, size_t depth, size_t children, TrieStats& partial) {
+                    partial.memoryBytes += Node::bytes(node->childCount);
+                    if (node->isEndOfWord) partial.words++;
+                    if (depth == 0) return;
+                    partial.totalNodes++;
+                    if (children == 0) return;
+                    partial.internalNodes++;
+                    if (children > 1) {
+                        partial.branchingNodes++;
+                        partial.branchingPaths += static_cast<int>(children);
+                        partial.pathBranchings++;
+                    }
+                },
+                threads);
+        }
+    };
+
+    PersistentTrie() {
+        working = allocate(0, false);
+        published = working;
+        retain(published);
+    }
+
+    ~PersistentTrie() {
+        release(working);
+        release(published);
+    }
+
+    PersistentTrie(const PersistentTrie&) = delete;
+    PersistentTrie& operator=(const PersistentTrie&) = delete;
+
+    // Изменения видны только писателю до publish(). Писатель один;
+    // одновременно с ним снимки берут и читают любые потоки.
+    bool insert(const std::string& word) {
+        std::vector<Node*> path;
+        path.reserve(word.size() + 1);
+        path.push_back(working);
+        size_t depth = 0;
+        while (depth < word.size()) {
+            Node* child = path.back()->getChild(word[depth]);
+            if (!child) break;
+            path.push_back(child);
+            depth++;
+        }
+        if (depth == word.size()) {
+            if (path.back()->isEndOfWord) return false;
+            commitPath(path, word, depth, { Edit::SET_END, 0, 0, nullptr, true, false });
+        }
+        else {
+            // Новый хвост собирается снизу вверх и подвешивается одной правкой
+            Node* tail = allocate(0, true);
+            for (size_t i = word.size() - 1; i > depth; i--) {
+                Node* node = allocate(1, false);
+                node->children()[0] = tail;
+                node->labels()[0] = word[i];
+                tail = node;
+            }
+            Node* parent = path.back();
+            commitPath(path, word, depth, { Edit::ADD, parent->lowerBound(word[depth]), word[depth], tail, false, false });
+        }
+        workingWords++;
+        return true;
+    }
+
+    bool erase(const std::string& word) {
+        std::vector<Node*> path;
+        path.reserve(word.size() + 1);
+        path.push_back(working);
+        for (char ch : word) {
+            Node* child = path.back()->getChild(ch);
+            if (!child) return false;
+            path.push_back(child);
+        }
+        if (!path.back()->isEndOfWord) return false;
+
+        // Самый верхний узел пути, после которого не остается слов;
+        // корень (пустое слово) не отсоединяется, с него снимается только признак
+        size_t cut = word.size();
+        if (path[cut]->childCount == 0) {
+            while (cut > 1 && path[cut - 1]->childCount == 1 && !path[cut - 1]->isEndOfWord) cut--;
+        }
+        if (cut == word.size() && (cut == 0 || path[cut]->childCount > 0)) {
+            commitPath(path, word, cut, { Edit::SET_END, 0, 0, nullptr, false, false });
+        }
+        else {
+            Node* parent = path[cut - 1];
+            commitPath(path, word, cut - 1, { Edit::REMOVE, parent->lowerBound(word[cut - 1]), 0, nullptr, false, false });
+        }
+        workingWords--;
+        return true;
+    }
+
+    // Публикация рабочей версии за O(1): новые снимки видят все изменения до этого места
+    void publish() {
+        retain(working);
+        Node* old;
+        {
+            std::lock_guard<std::mutex> guard(publishLock);
+            old = published;
+            published = working;
+            publishedWords = workingWords;
+        }
+        release(old);
+    }
+
+    // Последняя опубликованная версия за O(1)
+    Snapshot snapshot() const {
+        std::lock_guard<std::mutex> guard(publishLock);
+        retain(published);
+        return Snapshot(published, publishedWords);
+    }
+
+    // Поиск в рабочей версии (для писателя)
+    bool search(const std::string& word) const {
+        Node* current = working;
+        for (char ch : word) {
+            current = current->getChild(ch);
+            if (!current) return false;
+        }
+        return current->isEndOfWord;
+    }
+
+    size_t wordCount() const {
+        return workingWords;
+    }
+};
@@ -0,0 +1,16 @@
+﻿#pragma once
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <xmmintrin.h>
+#endif
+
+// Подсказка процессору загрузить строку кэша по адресу p заранее
+inline void prefetch(const void* p) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    __builtin_prefetch(p);
+#endif
+}
+
+// Количество одновременно выполняемых поисков в пакетном поиске
+const int BATCH_GROUP = 16;
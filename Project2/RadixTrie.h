@@ -0,0 +1,275 @@
+﻿#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Arena.h"
+#include "TrieStats.h"
+
+// Способ со сжатием путей (radix / Patricia): цепочки узлов с одним ребенком
+// хранятся одним ребром с меткой из нескольких символов
+
+struct RadixNode {
+    const char* label;       // Метка ребра, ведущего в узел (в арене)
+    uint32_t length;
+    bool isEndOfWord;
+    int childCount;
+    RadixNode* firstChild;   // Дети отсортированы по первому символу метки
+    RadixNode* nextSibling;
+
+    RadixNode(const char* label, uint32_t length)
+        : label(label), length(length), isEndOfWord(false), childCount(0),
+        firstChild(nullptr), nextSibling(nullptr) {}
+};
+
+class RadixTrie {
+private:
+    std::unique_ptr<Arena> ownArena;  // Собственная арена, если внешняя не передана
+    Arena* arena;
+    TrieStats counters;  // Параметры в символах исходного дерева
+    int nodes = 0;       // Узлы radix-дерева без корня
+
+    RadixNode* newNode(const char* text, size_t length) {
+        char* label = static_cast<char*>(arena->allocate(length, 1));
+        std::memcpy(label, text, length);
+        nodes++;
+        counters.memoryBytes += sizeof(RadixNode) + length;
+        return arena->create<RadixNode>(label, static_cast<uint32_t>(length));
+    }
+
+    // Учет цепочки из length символов, подвешенной к узлу parent
+    void countChain(RadixNode* parent, size_t length) {
+        counters.onChildAdded(parent->childCount, parent == root, 0);
+        counters.totalNodes += static_cast<int>(length - 1);
+        counters.internalNodes += static_cast<int>(length - 1);
+    }
+
+    void markEnd(RadixNode* node) {
+        if (!node->isEndOfWord) {
+            counters.words++;
+            node->isEndOfWord = true;
+        }
+    }
+
+    void resetCounters() {
+        counters = TrieStats();
+        counters.memoryBytes = sizeof(RadixNode);
+        nodes = 0;
+    }
+
+    // Возврат во внешнюю арену всех узлов (метки остаются в ней: их делят узлы после разбиения)
+    void releaseTree() {
+        std::vector<RadixNode*> stack;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            RadixNode* node = stack.back();
+            stack.pop_back();
+            for (RadixNode* child = node->firstChild; child; child = child->nextSibling) {
+                stack.push_back(child);
+            }
+            arena->destroy(node);
+        }
+    }
+
+public:
+    RadixNode* root;
+
+    explicit RadixTrie(Arena* externalArena = nullptr) {
+        if (!externalArena) {
+            ownArena.reset(new Arena());
+            externalArena = ownArena.get();
+        }
+        arena = externalArena;
+        root = arena->create<RadixNode>(nullptr, 0);
+        resetCounters();
+    }
+
+    // Собственная арена освобождается целиком; внешняя общая, поэтому узлы
+    // возвращаются в ее списки свободных и reset() для нее не вызывается
+    ~RadixTrie() {
+        if (!ownArena) releaseTree();
+    }
+
+    RadixTrie(const RadixTrie&) = delete;
+    RadixTrie& operator=(const RadixTrie&) = delete;
+
+    // Освобождение всех узлов: за O(1) в собственной арене, по одному - во внешней
+    void clear() {
+        if (ownArena) arena->reset();
+        else releaseTree();
+        root = arena->create<RadixNode>(nullptr, 0);
+        resetCounters();
+    }
+
+    void insert(const std::string& word) {
+        RadixNode* node = root;
+        size_t i = 0;
+        while (i < word.size()) {
+            RadixNode** link = &node->firstChild;
+            while (*link && static_cast<uint8_t>((*link)->label[0]) < static_cast<uint8_t>(word[i])) {
+                link = &(*link)->nextSibling;
+            }
+            RadixNode* child = *link;
+
+            if (!child || child->label[0] != word[i]) {
+                // Нет ребра на этот символ: остаток слова становится одним ребром
+                RadixNode* leaf = newNode(word.data() + i, word.size() - i);
+                countChain(node, word.size() - i);
+                leaf->nextSibling = child;
+                *link = leaf;
+                node->childCount++;
+                node = leaf;
+                break;
+            }
+
+            size_t k = 1;
+            while (k < child->length && i + k < word.size() && child->label[k] == word[i + k]) k++;
+            if (k < child->length) {
+                // Разрезаем ребро: новый узел получает общую часть метки,
+                // старый ребенок - ее остаток (без копирования символов)
+                RadixNode* mid = arena->create<RadixNode>(child->label, static_cast<uint32_t>(k));
+                nodes++;
+                counters.memoryBytes += sizeof(RadixNode);
+                mid->nextSibling = child->nextSibling;
+                mid->firstChild = child;
+                mid->childCount = 1;
+                child->label += k;
+                child->length -= static_cast<uint32_t>(k);
+                child->nextSibling = nullptr;
+                *link = mid;
+                child = mid;
+            }
+            node = child;
+            i += k;
+        }
+        markEnd(node);
+    }
+
+    // Построение из набора слов: сортировка и разбиение по общим префиксам,
+    // каждый узел создается один раз, без разрезания ребер
+    void build(std::vector<std::string> words) {
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+        clear();
+
+        struct Task {
+            RadixNode* node;
+            size_t lo, hi;  // Слова [lo, hi) проходят через node
+            size_t depth;   // Длина общего префикса
+        };
+        std::vector<Task> stack;
+        stack.push_back({ root, 0, words.size(), 0 });
+        while (!stack.empty()) {
+            Task task = stack.back();
+            stack.pop_back();
+            size_t lo = task.lo;
+            if (lo < task.hi && words[lo].size() == task.depth) {
+                task.node->isEndOfWord = true;
+                lo++;
+            }
+            RadixNode** tail = &task.node->firstChild;
+            while (lo < task.hi) {
+                char ch = words[lo][task.depth];
+                size_t hi = lo + 1;
+                while (hi < task.hi && words[hi][task.depth] == ch) hi++;
+
+                // Общий префикс группы равен общему префиксу первого и последнего слова
+                const std::string& first = words[lo];
+                const std::string& last = words[hi - 1];
+                size_t lcp = task.depth + 1;
+                while (lcp < first.size() && lcp < last.size() && first[lcp] == last[lcp]) lcp++;
+
+                RadixNode* child = newNode(first.data() + task.depth, lcp - task.depth);
+                *tail = child;
+                tail = &child->nextSibling;
+                task.node->childCount++;
+                stack.push_back({ child, lo, hi, lcp });
+                lo = hi;
+            }
+        }
+        counters = recount();
+    }
+
+    bool search(const std::string& word) const {
+        RadixNode* node = root;
+        size_t i = 0;
+        while (i < word.size()) {
+            RadixNode* child = node->firstChild;
+            while (child && child->label[0] != word[i]) child = child->nextSibling;
+            if (!child || child->length > word.size() - i ||
+                std::memcmp(child->label, word.data() + i, child->length) != 0) {
+                return false;
+            }
+            node = child;
+            i += child->length;
+        }
+        return node->isEndOfWord;
+    }
+
+    // Пересчет параметров за один обход с явным стеком
+    TrieStats recount() {
+        TrieStats result;
+        result.memoryBytes = sizeof(RadixNode);
+        nodes = 0;
+        std::vector<RadixNode*> stack;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            RadixNode* node = stack.back();
+            stack.pop_back();
+            if (node->isEndOfWord) result.words++;
+            for (RadixNode* child = node->firstChild; child; child = child->nextSibling) {
+                stack.push_back(child);
+            }
+            if (node == root) continue;
+
+            // Ребро длины length - это length исходных узлов, из них length - 1 с одним ребенком
+            nodes++;
+            result.memoryBytes += sizeof(RadixNode) + node->length;
+            result.totalNodes += node->length;
+            result.internalNodes += node->length - 1;
+            if (node->childCount > 0) result.internalNodes++;
+            if (node->childCount > 1) {
+                result.branchingNodes++;
+                result.branchingPaths += node->childCount;
+                result.pathBranchings++;
+            }
+        }
+        return result;
+    }
+
+    // Параметры дерева без обхода
+    const TrieStats& stats() const {
+        return counters;
+    }
+
+    size_t calculateMemoryUsage() const {
+        return counters.memoryBytes;
+    }
+
+    // Количество узлов radix-дерева (без корня)
+    int radixNodeCount() const {
+        return nodes;
+    }
+
+    int totalChars() const {
+        return counters.totalNodes;
+    }
+
+    int wordCount() const {
+        return counters.words;
+    }
+
+    int internalNodeCount() const {
+        return counters.internalNodes;
+    }
+
+    int branchingNodeCount() const {
+        return counters.branchingNodes;
+    }
+
+    double averageBranchingPaths() const {
+        return counters.avgBranching();
+    }
+};
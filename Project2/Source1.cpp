@@ -3,420 +3,67 @@
 #include <chrono>
 #include <random>
 #include <string>
+#include <memory>
+#include <algorithm>
+#include <span>
+#include "Arena.h"
+#include "Alphabet.h"
+#include "TrieStats.h"
+#include "ArrayTrie.h"
+#include "ListTrie.h"
+#include "Words.h"
+#include "AdaptiveTrie.h"
+#include "BurstTrie.h"
+#include "RadixTrie.h"
+#include "LoudsTrie.h"
+#include "DoubleArrayTrie.h"
+#include "Dawg.h"
+#include "MappedTrie.h"
+#include "Parallel.h"
+#include "ConcurrentTrie.h"
+#include "PersistentTrie.h"
+#include "Prefetch.h"
+#include "Autocomplete.h"
+#include "Cursor.h"
+#include "BasicTrie.h"
+#include "CountingArena.h"
+#include "Fuzzy.h"
+#include "AhoCorasick.h"
 using namespace std;
 
 
-// Способ с массивом
+void printStats(const TrieStats& stats) {
+    std::cout << std::endl << "Подсчет памяти" << std::endl;
 
-const int ALPHABET_SIZE = 26;
+    size_t totalMemory = stats.memoryBytes;
+    std::cout << "Память: " << totalMemory << " байт (~"
+        << totalMemory / 1024.0 << " KB)\n";
 
-struct TrieNodeArray {
-    TrieNodeArray* children[ALPHABET_SIZE];
-    bool isEndOfWord;
-
-    TrieNodeArray() : isEndOfWord(false) {
-        for (int i = 0; i < ALPHABET_SIZE; i++)
-            children[i] = nullptr;
-    }
-};
-
-// Функция для подсчета используемой памяти
-size_t calculateMemoryUsage(TrieNodeArray* node) {
-    if (!node) return 0;
-    size_t size = sizeof(*node); // Память для текущего узла
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        size += calculateMemoryUsage(node->children[i]); // Рекурсивно добавляем детей
-    }
-    return size;
-}
-
-
-
-TrieNodeArray* root = nullptr;  // Глобальная переменная для корня
-
-TrieNodeArray* getNode() {
-    return new TrieNodeArray();
-}
-
-void insert(TrieNodeArray* root, const string& key) {
-    TrieNodeArray* pCrawl = root;
-    for (char c : key) {
-        int index = c - 'a';
-        if (!pCrawl->children[index]) {
-            pCrawl->children[index] = getNode();
-        }
-        pCrawl = pCrawl->children[index];
-    }
-    pCrawl->isEndOfWord = true;
-}
-
-// Общее количество узлов (без корня)
-int countTotalNodes(TrieNodeArray* node) {
-    if (!node) return 0;
-    int count = 0;  // Не считаем текущий узел если это корень
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        count += countTotalNodes(node->children[i]);
-    }
-    return node == root ? count : count + 1;  // Пропускаем корень
-}
-
-// Количество слов (листовых вершин)
-int countLeafWords(TrieNodeArray* node) {
-    if (!node) return 0;
-    int count = node->isEndOfWord ? 1 : 0;
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        count += countLeafWords(node->children[i]);
-    }
-    return count;
+    std::cout << "\nПараметры дерева:\n";
+    std::cout << "1. Общее количество узлов (символов): " << stats.totalNodes << std::endl;
+    std::cout << "2. Количество слов (листовых вершин): " << stats.words << std::endl;
+    std::cout << "3. Количество внутренних вершин. " << stats.internalNodes << std::endl;
+    std::cout << "4. Количество ветвлений (внутренних вершин из которых более одного пути). " << stats.branchingNodes << std::endl;
+    std::cout << "5. Среднее количество путей в вершинах ветвлений. " << stats.avgBranching() << std::endl;
 }
 
-// Количество внутренних вершин (не корень и не листья)
-int countInternalNodes(TrieNodeArray* node, bool isRoot = true) {
-    if (!node) return 0;
-
-    bool hasChildren = false;
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        if (node->children[i]) {
-            hasChildren = true;
-            break;
-        }
-    }
-
-    int count = (!isRoot && hasChildren) ? 1 : 0;
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        count += countInternalNodes(node->children[i], false);
-    }
-    return count;
-}
-
-// Количество ветвлений (узлов с >1 ребенком, кроме корня)
-int countBranchingNodes(TrieNodeArray* node, bool isRoot = true) {
-    if (!node) return 0;
-
-    int childCount = 0;
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        if (node->children[i]) childCount++;
-    }
-
-    int count = (!isRoot && childCount > 1) ? 1 : 0;
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        count += countBranchingNodes(node->children[i], false);
-    }
-    return count;
-}
-
-bool hasAnyWord(TrieNodeArray* node) {
-    if (!node) return false;
-    if (node->isEndOfWord) return true;
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        if (hasAnyWord(node->children[i])) return true;
-    }
-    return false;
+// Память по данным распределителя (включая выравнивание и недоиспользованные блоки)
+void printMemoryStats(const MemoryStats& memory) {
+    std::cout << "Распределитель: " << memory.liveBytes << " байт в " << memory.liveObjects
+        << " объектах (пик " << memory.peakLiveBytes << "), выравнивание " << memory.paddingBytes
+        << " байт, взято у системы " << memory.reservedBytes << " байт в "
+        << memory.systemAllocations << " блоках (пик " << memory.peakReservedBytes << ")\n";
 }
 
-pair<int, int> countRealBranchings(TrieNodeArray* node, bool isRoot = true) {
-    if (!node) return { 0, 0 };
-
-    int childCount = 0;
-    vector<TrieNodeArray*> activeChildren;
-    for (int i = 0; i < ALPHABET_SIZE; i++) {
-        if (node->children[i]) {
-            childCount++;
-            activeChildren.push_back(node->children[i]);
-        }
-    }
-
-    bool isRealBranch = false;
-    if (childCount > 1 && !isRoot) {
-        int wordPaths = 0;
-        for (auto child : activeChildren) {
-            if (child->isEndOfWord) wordPaths++;
-            if (hasAnyWord(child)) wordPaths++;
-            if (wordPaths >= 2) {
-                isRealBranch = true;
-                break;
-            }
-        }
+void printShape(const ShapeHistogram& shape) {
+    std::cout << "Глубина: узлов / среднее число детей\n";
+    for (size_t depth = 0; depth < shape.nodesAtDepth.size(); depth++) {
+        std::cout << "  " << depth << ": " << shape.nodesAtDepth[depth] << " / "
+            << static_cast<double>(shape.childrenAtDepth[depth]) / shape.nodesAtDepth[depth] << "\n";
     }
-
-    int sum = 0, count = 0;
-    if (isRealBranch) {
-        sum = childCount;
-        count = 1;
-    }
-
-    for (auto child : activeChildren) {
-        auto childStats = countRealBranchings(child, false);
-        sum += childStats.first;
-        count += childStats.second;
-    }
-
-    return { sum, count };
-}
-
-double calculateAvgBranching(TrieNodeArray* root) {
-    auto stats = countRealBranchings(root);
-    return (stats.second == 0) ? 0.0 :
-        static_cast<double>(stats.first) / stats.second;
-}
-
-// Способ с листом
-
-class TrieNode;
-
-struct ListNode {
-    char ch;
-    TrieNode* next;
-    ListNode* nextListNode;
-
-    ListNode(char c) : ch(c), next(nullptr), nextListNode(nullptr) {}
-};
-
-class TrieNode {
-public:
-    ListNode* head;
-    bool isEndOfWord;
-
-    TrieNode() : head(nullptr), isEndOfWord(false) {}
-
-    TrieNode* getChild(char ch) {
-        ListNode* current = head;
-        while (current) {
-            if (current->ch == ch) {
-                return current->next;
-            }
-            current = current->nextListNode;
-        }
-        return nullptr;
-    }
-
-    void addChild(char ch) {
-        if (!head) {
-            head = new ListNode(ch);
-            head->next = new TrieNode();
-        }
-        else {
-            ListNode* current = head;
-            while (current->nextListNode) {
-                if (current->ch == ch) {
-                    return;
-                }
-                current = current->nextListNode;
-            }
-            current->nextListNode = new ListNode(ch);
-            current->nextListNode->next = new TrieNode();
-        }
-    }
-};
-
-class Trie {
-private:
-
-    int countChars(TrieNode* node) {
-        if (!node) return 0;
-
-        int count = 0;
-        ListNode* current = node->head;
-        while (current) {
-            count += 1 + countChars(current->next);
-            current = current->nextListNode;
-        }
-        return count;
-    }
-
-    int countWords(TrieNode* node) {
-        if (!node) return 0;
-
-        int count = node->isEndOfWord ? 1 : 0;
-        ListNode* current = node->head;
-        while (current) {
-            count += countWords(current->next);
-            current = current->nextListNode;
-        }
-        return count;
-    }
-
-    int countInternalNodes(TrieNode* node, bool isRoot = true) {
-        if (!node || !node->head) return 0;
-
-        int count = isRoot ? 0 : 1;
-        ListNode* current = node->head;
-
-        while (current) {
-            count += countInternalNodes(current->next, false);
-            current = current->nextListNode;
-        }
-
-        return count;
-    }
-
-    int countBranchingNodes(TrieNode* node) {
-        if (!node || !node->head) return 0;
-
-        int count = 0;
-        if (node->head && node->head->nextListNode && node != root) {
-            count = 1;
-        }
-
-        ListNode* current = node->head;
-        while (current) {
-            count += countBranchingNodes(current->next);
-            current = current->nextListNode;
-        }
-        return count;
-    }
-
-    void calculateBranchingPaths(TrieNode* node, int& totalPaths) {
-        if (!node || !node->head) return;
-
-        int paths = 0;
-        ListNode* current = node->head;
-        while (current) {
-            paths++;
-            current = current->nextListNode;
-        }
-        if (paths > 1 && node != root) {
-            totalPaths += paths;
-        }
-
-        current = node->head;
-        while (current) {
-            calculateBranchingPaths(current->next, totalPaths);
-            current = current->nextListNode;
-        }
-    }
-public:
-    TrieNode* root;
-
-    int countTrieNodes(TrieNode* node) {
-        if (!node) return 0;
-        int count = 1;
-        ListNode* current = node->head;
-        while (current) {
-            count += countTrieNodes(current->next);
-            current = current->nextListNode;
-        }
-        return count;
-    }
-
-    int countListNodes(TrieNode* node) {
-        if (!node) return 0;
-        int count = 0;
-        ListNode* current = node->head;
-        while (current) {
-            count += 1 + countListNodes(current->next);
-            current = current->nextListNode;
-        }
-        return count;
-    }
-
-    void printTree() {
-        printNode(root, "", true);
-    }
-
-    void printNode(TrieNode* node, const std::string& prefix, bool isLast) {
-        if (!node) return;
-
-        if (node == root) {
-            std::cout << prefix << (isLast ? "`-- " : "|-- ") << "[root]\n";
-        }
-
-        ListNode* current = node->head;
-        while (current) {
-            std::string newPrefix = prefix + (isLast ? "    " : "|   ");
-
-            std::cout << newPrefix;
-            std::cout << (current->nextListNode ? "|-- " : "`-- ");
-            std::cout << current->ch;
-            if (current->next->isEndOfWord) {
-                std::cout << " (end)";
-            }
-            std::cout << "\n";
-
-            printNode(current->next, newPrefix, !current->nextListNode);
-
-            current = current->nextListNode;
-        }
-    }
-    Trie() {
-        root = new TrieNode();
-    }
-
-    void insert(const std::string& word) {
-        TrieNode* current = root;
-        for (char ch : word) {
-            TrieNode* child = current->getChild(ch);
-            if (!child) {
-                current->addChild(ch);
-                child = current->getChild(ch);
-            }
-            current = child;
-        }
-        current->isEndOfWord = true;
-    }
-
-    bool search(const std::string& word) {
-        TrieNode* current = root;
-        for (char ch : word) {
-            TrieNode* child = current->getChild(ch);
-            if (!child) {
-                return false;
-            }
-            current = child;
-        }
-        return current->isEndOfWord;
-    }
-
-    // 1. Общее количество символов
-    int totalChars() {
-        return countChars(root);
-    }
-
-    // 2. Количество слов (листовых вершин в дереве)
-    int wordCount() {
-        return countWords(root);
-    }
-
-    // 3. Количество внутренних вершин
-    int internalNodeCount() {
-        return countInternalNodes(root);
-    }
-
-    // 4. Количество ветвлений (внутренних вершин из которых более одного пути)
-    int branchingNodeCount() {
-        return countBranchingNodes(root);
-    }
-
-    // 5. Среднее количество путей в вершинах ветвлений
-    double averageBranchingPaths() {
-        int branchCount = branchingNodeCount();
-        int totalPaths = 0;
-        calculateBranchingPaths(root, totalPaths);
-        return branchCount > 0 ? static_cast<double>(totalPaths) / branchCount : 0.0;
-    }
-};
-void generateWords(std::vector<std::string>& words, int minLen, int maxLen, int n) {
-    static const std::string alphabet = "abcdefghijklmnopqrstuvwxyz";
-    std::mt19937 rng(static_cast<unsigned>(std::time(nullptr)));
-    std::uniform_int_distribution<int> lenDist(minLen, maxLen);
-    std::uniform_int_distribution<int> charDist(0, alphabet.size() - 1);
-
-    std::uniform_int_distribution<int> rand(0, 100);
-
-    words.clear();
-
-    while (n > 0) {
-        std::string word;
-        int lineLen = 0;
-        while (lineLen == 0 || (rand(rng) >= 15 && n != 0)) {
-            word += alphabet[charDist(rng)];
-            lineLen++;
-            n--;
-            if (n % 50 == 0) {
-                break;
-            }
-        }
-        words.push_back(word);
+    std::cout << "Детей: узлов\n";
+    for (size_t children = 0; children < shape.fanout.size(); children++) {
+        if (shape.fanout[children]) std::cout << "  " << children << ": " << shape.fanout[children] << "\n";
     }
 }
 
@@ -472,15 +119,18 @@ int main() {
     // Массив
     
     cout<<endl <<"***************************** Способ 1: массив ***********************************"<<endl;
+    cout << "Размер узла: латиница " << sizeof(BasicTrieNodeArray<LatinAlphabet>)
+        << " байт, кириллица " << sizeof(BasicTrieNodeArray<CyrillicAlphabet>)
+        << " байт, ASCII " << sizeof(BasicTrieNodeArray<AsciiAlphabet>) << " байт" << endl;
     for (size_t i = 1; i <= 10; i++)
     {
-        int currentN = 0;
-        root = getNode();
+        size_t currentN = 0;
+        ArrayTrie trie;
         int j = 0;
         auto start_time = std::chrono::high_resolution_clock::now();
         while (true)
         {
-            insert(root,words[j]);
+            trie.insert(words[j]);
             currentN += words[j].length();
             if (currentN == i * 50) break;
             j++;
@@ -491,24 +141,45 @@ int main() {
 
         std::cout << "Время постройки дерева: " << duration.count() << " микросекунд\n";
 
-        std::cout << std::endl << "Подсчет памяти" << std::endl;
+        printStats(trie.stats());
 
-        size_t totalMemory = calculateMemoryUsage(root);
-        std::cout << "Память: " << totalMemory << " байт (~"
-            << totalMemory / 1024.0 << " KB)\n";
-
-        std::cout << "\nПараметры дерева:\n";
-        std::cout << "1. Общее количество узлов (символов): " << countTotalNodes(root) << std::endl;
-        std::cout << "2. Количество слов (листовых вершин): " << countLeafWords(root) << std::endl;
-        std::cout << "3. Количество внутренних вершин. " << countInternalNodes(root) << std::endl;
-        std::cout << "4. Количество ветвлений (внутренних вершин из которых более одного пути). " << countBranchingNodes(root) << std::endl;
-        std::cout << "5. Среднее количество путей в вершинах ветвлений. " << calculateAvgBranching(root) << std::endl;
+        BasicArrayTrie<LatinAlphabet, CountingArena> counted;
+        for (int k = 0; k <= j; k++) {
+            counted.insert(words[k]);
+        }
+        printMemoryStats(counted.allocator().stats());
+        if (i == 10) printShape(counted.shape());
+
+        Arena parallelArena;
+        TrieStats parallelStats;
+        start_time = std::chrono::high_resolution_clock::now();
+        buildParallel(std::vector<std::string>(words.begin(), words.begin() + j + 1),
+            defaultThreadCount(), parallelStats, parallelArena);
+        end_time = std::chrono::high_resolution_clock::now();
+        duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        std::cout << "Время параллельной постройки: " << duration.count() << " микросекунд\n";
+
+        // Поиск всех вставленных слов по одному и пакетом
+        std::span<const std::string> queries(words.data(), j + 1);
+        std::unique_ptr<bool[]> found(new bool[queries.size()]);
+        start_time = std::chrono::high_resolution_clock::now();
+        for (size_t k = 0; k < queries.size(); k++) {
+            found[k] = trie.search(queries[k]);
+        }
+        end_time = std::chrono::high_resolution_clock::now();
+        auto single = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        start_time = std::chrono::high_resolution_clock::now();
+        searchBatch(trie.root, queries, std::span<bool>(found.get(), queries.size()));
+        end_time = std::chrono::high_resolution_clock::now();
+        duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        std::cout << "Время поиска: " << single.count() << " микросекунд, пакетного поиска: "
+            << duration.count() << " микросекунд\n";
     }
     // Список
     cout << endl << "***************************** Способ 2: список ***********************************" << endl;
     for (size_t i = 1; i <= 10; i++)
     {
-        int currentN = 0;
+        size_t currentN = 0;
         Trie trie;
         int j = 0;
         auto start_time = std::chrono::high_resolution_clock::now();
@@ -525,27 +196,340 @@ int main() {
 
         std::cout << "Время постройки дерева: " << duration.count() << " микросекунд\n";
 
-        std::cout << std::endl << "Подсчет памяти" << std::endl;
+        printStats(trie.stats());
+
+        BasicTrie<ListNodePolicy, CountingArena> counted;
+        for (int k = 0; k <= j; k++) {
+            counted.insert(words[k]);
+        }
+        printMemoryStats(counted.allocator().stats());
+        if (i == 10) printShape(counted.shape());
+
+        // Удаление каждого второго слова и уплотнение оставшихся узлов
+        for (int k = 0; k <= j; k += 2) {
+            counted.erase(words[k]);
+        }
+        std::cout << "После удаления половины слов (осталось " << counted.wordCount() << "):\n";
+        printMemoryStats(counted.allocator().stats());
+        counted.compact();
+        std::cout << "После уплотнения:\n";
+        printMemoryStats(counted.allocator().stats());
+
+        Trie parallelTrie;
+        start_time = std::chrono::high_resolution_clock::now();
+        parallelTrie.buildParallel(std::vector<std::string>(words.begin(), words.begin() + j + 1));
+        end_time = std::chrono::high_resolution_clock::now();
+        duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        std::cout << "Время параллельной постройки: " << duration.count() << " микросекунд\n";
+
+        // Поиск всех вставленных слов по одному и пакетом
+        std::span<const std::string> queries(words.data(), j + 1);
+        std::unique_ptr<bool[]> found(new bool[queries.size()]);
+        start_time = std::chrono::high_resolution_clock::now();
+        for (size_t k = 0; k < queries.size(); k++) {
+            found[k] = trie.search(queries[k]);
+        }
+        end_time = std::chrono::high_resolution_clock::now();
+        auto single = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        start_time = std::chrono::high_resolution_clock::now();
+        trie.searchBatch(queries, std::span<bool>(found.get(), queries.size()));
+        end_time = std::chrono::high_resolution_clock::now();
+        duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        std::cout << "Время поиска: " << single.count() << " микросекунд, пакетного поиска: "
+            << duration.count() << " микросекунд\n";
+
+        start_time = std::chrono::high_resolution_clock::now();
+        std::vector<Completion> top = trie.complete(words[0].substr(0, 1), 10);
+        end_time = std::chrono::high_resolution_clock::now();
+        duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        std::cout << "Автодополнение \"" << words[0][0] << "\": " << top.size() << " слов за "
+            << duration.count() << " микросекунд\n";
+
+        start_time = std::chrono::high_resolution_clock::now();
+        std::vector<FuzzyMatch> similar = trie.searchFuzzy(words[0], 1);
+        end_time = std::chrono::high_resolution_clock::now();
+        duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        std::cout << "Нечеткий поиск \"" << words[0] << "\" (1 правка): " << similar.size() << " слов за "
+            << duration.count() << " микросекунд\n";
+
+        // Все вхождения слов дерева в склеенный текст, подаваемый кусками
+        std::string text;
+        for (size_t k = 0; k < queries.size(); k++) {
+            text += queries[k];
+        }
+        AhoCorasick matcher = trie.automaton();
+        AhoCorasick::Scanner scanner = matcher.scanner();
+        size_t occurrences = 0;
+        start_time = std::chrono::high_resolution_clock::now();
+        for (size_t pos = 0; pos < text.size(); pos += 64) {
+            scanner.scan(std::string_view(text).substr(pos, 64), [&](size_t, size_t) { occurrences++; });
+        }
+        end_time = std::chrono::high_resolution_clock::now();
+        duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        std::cout << "Ахо-Корасик: " << occurrences << " вхождений в " << text.size() << " символах за "
+            << duration.count() << " микросекунд\n";
+
+        // Полный упорядоченный обход курсором
+        start_time = std::chrono::high_resolution_clock::now();
+        size_t scanned = 0;
+        ListCursor scan = trie.cursor();
+        while (scan.next()) {
+            scanned++;
+        }
+        end_time = std::chrono::high_resolution_clock::now();
+        duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        std::cout << "Упорядоченный обход: " << scanned << " слов за " << duration.count() << " микросекунд\n";
+    }
+    // Адаптивные узлы
+    cout << endl << "*********************** Способ 3: адаптивные узлы ********************************" << endl;
+    for (size_t i = 1; i <= 10; i++)
+    {
+        size_t currentN = 0;
+        AdaptiveTrie trie;
+        int j = 0;
+        auto start_time = std::chrono::high_resolution_clock::now();
+        while (true)
+        {
+            trie.insert(words[j]);
+            currentN += words[j].length();
+            if (currentN == i * 50) break;
+            j++;
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::cout << std::endl << "---------------- n = " << currentN << " ----------------" << std::endl;
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+        std::cout << "Время постройки дерева: " << duration.count() << " микросекунд\n";
+
+        printStats(trie.stats());
+    }
+    // Сжатие путей
+    cout << endl << "************************* Способ 4: сжатие путей *********************************" << endl;
+    for (size_t i = 1; i <= 10; i++)
+    {
+        size_t currentN = 0;
+        RadixTrie trie;
+        int j = 0;
+        auto start_time = std::chrono::high_resolution_clock::now();
+        while (true)
+        {
+            trie.insert(words[j]);
+            currentN += words[j].length();
+            if (currentN == i * 50) break;
+            j++;
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::cout << std::endl << "---------------- n = " << currentN << " ----------------" << std::endl;
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+        std::cout << "Время постройки дерева: " << duration.count() << " микросекунд\n";
+        std::cout << "Узлов в radix-дереве: " << trie.radixNodeCount() << std::endl;
+
+        RadixTrie bulk;
+        start_time = std::chrono::high_resolution_clock::now();
+        bulk.build(std::vector<std::string>(words.begin(), words.begin() + j + 1));
+        end_time = std::chrono::high_resolution_clock::now();
+        duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        std::cout << "Время пакетного построения: " << duration.count() << " микросекунд\n";
+
+        printStats(trie.stats());
+    }
+    // Заморозка в LOUDS
+    cout << endl << "************************** Способ 5: LOUDS (заморозка) ***************************" << endl;
+    for (size_t i = 1; i <= 10; i++)
+    {
+        size_t currentN = 0;
+        Trie trie;
+        int j = 0;
+        while (true)
+        {
+            trie.insert(words[j]);
+            currentN += words[j].length();
+            if (currentN == i * 50) break;
+            j++;
+        }
+        auto start_time = std::chrono::high_resolution_clock::now();
+        LoudsTrie frozen = trie.freeze();
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::cout << std::endl << "---------------- n = " << currentN << " ----------------" << std::endl;
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+        std::cout << "Время заморозки дерева: " << duration.count() << " микросекунд\n";
 
-        int totalTrieNodes = trie.countTrieNodes(trie.root);
-        int totalListNodes = trie.countListNodes(trie.root);
+        printStats(frozen.stats());
+    }
+    // Двойной массив
+    cout << endl << "************************** Способ 6: двойной массив ******************************" << endl;
+    for (size_t i = 1; i <= 10; i++)
+    {
+        size_t currentN = 0;
+        int j = 0;
+        while (true)
+        {
+            currentN += words[j].length();
+            if (currentN == i * 50) break;
+            j++;
+        }
+        std::vector<std::string> sorted(words.begin(), words.begin() + j + 1);
+        std::sort(sorted.begin(), sorted.end());
 
-        //std::cout << "totalTrieNodes = " << totalTrieNodes << std::endl;
-        //std::cout << "totalListNodes = " << totalListNodes << std::endl;
+        DoubleArrayTrie trie;
+        auto start_time = std::chrono::high_resolution_clock::now();
+        trie.build(sorted);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::cout << std::endl << "---------------- n = " << currentN << " ----------------" << std::endl;
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
-        //std::cout << "sizeof(TrieNode)) = " << sizeof(TrieNode) << std::endl;
-        //std::cout << "sizeof(ListNode) = " << sizeof(ListNode) << std::endl;
+        std::cout << "Время постройки дерева: " << duration.count() << " микросекунд\n";
 
-        size_t totalMemory = (totalTrieNodes * sizeof(TrieNode)) + (totalListNodes * sizeof(ListNode));
-        std::cout << "Память: " << totalMemory << " байт (~"
-            << totalMemory / 1024.0 << " KB)\n";
+        // Запись в файл и загрузка через отображение в память
+        const std::string path = "trie.datr";
+        MappedTrie mapped;
+        if (writeTrieFile(trie, path)) {
+            start_time = std::chrono::high_resolution_clock::now();
+            bool opened = mapped.open(path);
+            end_time = std::chrono::high_resolution_clock::now();
+            duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+            if (opened) {
+                std::cout << "Время загрузки из файла: " << duration.count() << " микросекунд, "
+                    << mapped.stats().memoryBytes << " байт\n";
+            }
+            mapped.close();
+            std::remove(path.c_str());
+        }
 
-        std::cout << "\nПараметры дерева:\n";
-        std::cout << "1. Общее количество узлов (символов): " << trie.totalChars() << std::endl;
-        std::cout << "2. Количество слов (листовых вершин): " << trie.wordCount() << std::endl;
-        std::cout << "3. Количество внутренних вершин. " << trie.internalNodeCount() << std::endl;
-        std::cout << "4. Количество ветвлений (внутренних вершин из которых более одного пути). " << trie.branchingNodeCount() << std::endl;
-        std::cout << "5. Среднее количество путей в вершинах ветвлений. " << trie.averageBranchingPaths() << std::endl;
+        printStats(trie.stats());
+    }
+    // Многопоточная вставка без блокировок
+    cout << endl << "******************** Способ 7: массив, вставка без блокировок ********************" << endl;
+    for (size_t i = 1; i <= 10; i++)
+    {
+        size_t currentN = 0;
+        int j = 0;
+        while (true)
+        {
+            currentN += words[j].length();
+            if (currentN == i * 50) break;
+            j++;
+        }
+
+        // Писатели вставляют слова через одно, читатель параллельно ищет все слова
+        ConcurrentTrie trie;
+        unsigned writers = max(defaultThreadCount(), 2u);
+        std::atomic<int> found(0);
+        auto start_time = std::chrono::high_resolution_clock::now();
+        parallelFor(writers + 1, writers + 1, [&](unsigned, size_t task) {
+            if (task == writers) {
+                for (int k = 0; k <= j; k++) {
+                    if (trie.search(words[k])) found++;
+                }
+                return;
+            }
+            ConcurrentTrie::Writer writer = trie.writer();
+            for (int k = static_cast<int>(task); k <= j; k += writers) {
+                writer.insert(words[k]);
+            }
+        });
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::cout << std::endl << "---------------- n = " << currentN << " ----------------" << std::endl;
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+        std::cout << "Время постройки дерева (" << writers << " потоков): " << duration.count() << " микросекунд\n";
+        std::cout << "Найдено читателем во время вставки: " << found << std::endl;
+
+        printStats(trie.stats());
+    }
+    // Минимальный автомат с общими окончаниями
+    cout << endl << "********************** Способ 8: DAWG (общие окончания) **************************" << endl;
+    for (size_t i = 1; i <= 10; i++)
+    {
+        size_t currentN = 0;
+        int j = 0;
+        while (true)
+        {
+            currentN += words[j].length();
+            if (currentN == i * 50) break;
+            j++;
+        }
+        std::vector<std::string> sorted(words.begin(), words.begin() + j + 1);
+        std::sort(sorted.begin(), sorted.end());
+
+        Dawg trie;
+        auto start_time = std::chrono::high_resolution_clock::now();
+        trie.build(sorted);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::cout << std::endl << "---------------- n = " << currentN << " ----------------" << std::endl;
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+        std::cout << "Время постройки дерева: " << duration.count() << " микросекунд\n";
+        std::cout << "Узлов: " << trie.nodeCount() << " вместо " << trie.trieNodeCount()
+            << " в дереве, сэкономлено " << trie.savedNodes() << std::endl;
+
+        printStats(trie.stats());
+    }
+    // Узлы сверху, корзины строк в хвостах
+    cout << endl << "********************* Способ 9: гибрид дерева и корзин ***************************" << endl;
+    for (size_t i = 1; i <= 10; i++)
+    {
+        size_t currentN = 0;
+        BurstTrie trie;
+        int j = 0;
+        auto start_time = std::chrono::high_resolution_clock::now();
+        while (true)
+        {
+            trie.insert(words[j]);
+            currentN += words[j].length();
+            if (currentN == i * 50) break;
+            j++;
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::cout << std::endl << "---------------- n = " << currentN << " ----------------" << std::endl;
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+        std::cout << "Время постройки дерева: " << duration.count() << " микросекунд\n";
+        std::cout << "Узлов: " << trie.nodeCount() << ", корзин: " << trie.bucketCount() << std::endl;
+
+        printStats(trie.recount());
+    }
+    // Версии со снимками для читателей
+    cout << endl << "******************* Способ 10: постоянное дерево (снимки) ************************" << endl;
+    for (size_t i = 1; i <= 10; i++)
+    {
+        size_t currentN = 0;
+        PersistentTrie trie;
+        int j = 0;
+        auto start_time = std::chrono::high_resolution_clock::now();
+        while (true)
+        {
+            trie.insert(words[j]);
+            currentN += words[j].length();
+            if (currentN == i * 50) break;
+            j++;
+        }
+        trie.publish();
+        auto end_time = std::chrono::high_resolution_clock::now();
+        std::cout << std::endl << "---------------- n = " << currentN << " ----------------" << std::endl;
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+        std::cout << "Время постройки дерева: " << duration.count() << " микросекунд\n";
+
+        // Читатель держит снимок, пока писатель удаляет половину слов
+        PersistentTrie::Snapshot before = trie.snapshot();
+        size_t nodesBefore = persistentNodeCount;
+        start_time = std::chrono::high_resolution_clock::now();
+        for (int k = 0; k <= j; k += 2) {
+            trie.erase(words[k]);
+        }
+        trie.publish();
+        end_time = std::chrono::high_resolution_clock::now();
+        duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        PersistentTrie::Snapshot after = trie.snapshot();
+        std::cout << "Удаление половины слов: " << duration.count() << " микросекунд, слов в снимке до: "
+            << before.wordCount() << ", после: " << after.wordCount() << std::endl;
+        std::cout << "Узлов: " << nodesBefore << " до удаления, " << persistentNodeCount
+            << " вместе со старой версией" << std::endl;
+
+        printStats(after.recount());
     }
     
     
@@ -0,0 +1,103 @@
+﻿#pragma once
+#include <cstddef>
+#include <vector>
+
+// Пять параметров дерева и занимаемая память, собранные за один обход
+struct TrieStats {
+    int totalNodes = 0;      // 1. Общее количество узлов (символов), без корня
+    int words = 0;           // 2. Количество слов
+    int internalNodes = 0;   // 3. Внутренние вершины (не корень и не листья)
+    int branchingNodes = 0;  // 4. Вершины, из которых более одного пути
+    int branchingPaths = 0;  // Сумма путей по вершинам ветвлений
+    int pathBranchings = 0;  // Ветвления, учтенные в среднем
+    size_t memoryBytes = 0;  // Память под узлы
+
+    // Учет нового узла, добавленного к родителю, у которого было childCount детей
+    void onChildAdded(int childCount, bool parentIsRoot, size_t nodeBytes) {
+        totalNodes++;
+        memoryBytes += nodeBytes;
+        if (parentIsRoot) return;
+        if (childCount == 0) {
+            internalNodes++;  // Лист стал внутренней вершиной
+        }
+        else if (childCount == 1) {
+            branchingNodes++;  // Второй ребенок: появилось ветвление
+            branchingPaths += 2;
+            pathBranchings++;
+        }
+        else {
+            branchingPaths++;
+        }
+    }
+
+    // Обратное к onChildAdded: у родителя осталось childCount детей после удаления узла
+    void onChildRemoved(int childCount, bool parentIsRoot, size_t nodeBytes) {
+        totalNodes--;
+        memoryBytes -= nodeBytes;
+        if (parentIsRoot) return;
+        if (childCount == 0) {
+            internalNodes--;
+        }
+        else if (childCount == 1) {
+            branchingNodes--;
+            branchingPaths -= 2;
+            pathBranchings--;
+        }
+        else {
+            branchingPaths--;
+        }
+    }
+
+    // Сложение частичных результатов (например, по поддеревьям)
+    TrieStats& operator+=(const TrieStats& other) {
+        totalNodes += other.totalNodes;
+        words += other.words;
+        internalNodes += other.internalNodes;
+        branchingNodes += other.branchingNodes;
+        branchingPaths += other.branchingPaths;
+        pathBranchings += other.pathBranchings;
+        memoryBytes += other.memoryBytes;
+        return *this;
+    }
+
+    // 5. Среднее количество путей в вершинах ветвлений
+    double avgBranching() const {
+        return pathBranchings == 0 ? 0.0 :
+            static_cast<double>(branchingPaths) / pathBranchings;
+    }
+};
+
+// Форма дерева: число узлов и их детей на каждой глубине, распределение узлов по числу детей
+struct ShapeHistogram {
+    std::vector<size_t> nodesAtDepth;     // Узлов на глубине d (корень - глубина 0)
+    std::vector<size_t> childrenAtDepth;  // Сумма детей узлов глубины d
+    std::vector<size_t> fanout;           // Узлов ровно с k детьми
+
+    void add(size_t depth, size_t children) {
+        if (nodesAtDepth.size() <= depth) {
+            nodesAtDepth.resize(depth + 1);
+            childrenAtDepth.resize(depth + 1);
+        }
+        nodesAtDepth[depth]++;
+        childrenAtDepth[depth] += children;
+        if (fanout.size() <= children) fanout.resize(children + 1);
+        fanout[children]++;
+    }
+
+    // Сложение частичных результатов
+    ShapeHistogram& operator+=(const ShapeHistogram& other) {
+        if (nodesAtDepth.size() < other.nodesAtDepth.size()) {
+            nodesAtDepth.resize(other.nodesAtDepth.size());
+            childrenAtDepth.resize(other.childrenAtDepth.size());
+        }
+        for (size_t depth = 0; depth < other.nodesAtDepth.size(); depth++) {
+            nodesAtDepth[depth] += other.nodesAtDepth[depth];
+            childrenAtDepth[depth] += other.childrenAtDepth[depth];
+        }
+        if (fanout.size() < other.fanout.size()) fanout.resize(other.fanout.size());
+        for (size_t k = 0; k < other.fanout.size(); k++) {
+            fanout[k] += other.fanout[k];
+        }
+        return *this;
+    }
+};
@@ -0,0 +1,34 @@
+﻿#pragma once
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+
+// Случайные слова из строчной латиницы общей длиной n символов. Слова не переходят
+// через границы, кратные 50 символам, поэтому первые 50*i символов - целые слова.
+// При одинаковом seed результат одинаков.
+inline void generateWords(std::vector<std::string>& words, int minLen, int maxLen, int n,
+    unsigned seed = static_cast<unsigned>(std::time(nullptr))) {
+    static const std::string alphabet = "abcdefghijklmnopqrstuvwxyz";
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> lenDist(minLen, maxLen);
+    std::uniform_int_distribution<int> charDist(0, alphabet.size() - 1);
+
+    std::uniform_int_distribution<int> rand(0, 100);
+
+    words.clear();
+
+    while (n > 0) {
+        std::string word;
+        int lineLen = 0;
+        while (lineLen == 0 || (rand(rng) >= 15 && n != 0)) {
+            word += alphabet[charDist(rng)];
+            lineLen++;
+            n--;
+            if (n % 50 == 0) {
+                break;
+            }
+        }
+        words.push_back(word);
+    }
+}